@@ -1,14 +1,22 @@
+#include <errno.h>
+#include <fcntl.h>
 #include <libtcc.h>
+#include <limits.h>
 #include <locale.h>
 #include <math.h>
+#include <pthread.h>
 #include <raylib.h>
 #include <raymath.h>
+#include <rlgl.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 /* --constants-- */
 #define MAX_VARIABLES 100
@@ -25,6 +33,20 @@
 #define GRID_SQR_COLOR LIGHTGRAY
 #define GRID_BIG_COLOR DARKGRAY
 
+#define LAYOUT_NODE_GAP 40      // aynı katmandaki düğümler arası boşluk
+#define LAYOUT_LAYER_GAP 60     // katmanlar arası boşluk
+#define LAYOUT_COMPONENT_GAP 150
+#define LAYOUT_ROW_WIDTH 3000   // bileşen satırlarının en küçük genişliği
+#define LAYOUT_DUMMY_WIDTH 20
+#define LAYOUT_SWEEPS 8         // kesişim azaltma taramaları
+#define LAYOUT_ALIGN_PASSES 4   // yatay hizalama turları
+#define LAYOUT_ANIMATION_SPEED 10
+
+#define SDF_BASE_SIZE 32 // glifler bu boyutta taranır, her boyuta ölçeklenir
+#define SDF_ATLAS_WIDTH 1024
+#define SDF_ATLAS_HEIGHT 256 // başlangıç; doldukça ikiye katlanır
+#define SDF_LINE_GAP 2
+
 #define NODE_TYPE_NAME                                                         \
   (char *[]){"Başla", "Bitir", "İşlem", "Değer", "Çağır",                      \
              "Giriş", "Çıkış", "Karar", "Döngü"}
@@ -48,67 +70,577 @@ typedef enum {
   NODE_LOOP,
 } NodeType;
 
-typedef struct Node {
-  NodeType type;
-  Vector2 position;
+#define NODE_NONE -1
+
+#define NODE_FLAG_SELECTED 0x01
+#define NODE_FLAG_EDITING 0x02
+#define NODE_FLAG_EDITABLE 0x04
+#define NODE_FLAG_DIRTY 0x08 // metin değişti, sınırlar yeniden ölçülmeli
+#define NODE_FLAG_REACHABLE 0x10 // bir Başla düğümünden ulaşılabiliyor
+
+/* --ifade ağacı-- */
+typedef enum {
+  VALUE_UNKNOWN,
+  VALUE_INT,
+  VALUE_FLOAT,
+  VALUE_CHAR,
+  VALUE_STRING,
+  VALUE_VOID,
+} ValueType;
+
+typedef enum {
+  EXPR_INT,
+  EXPR_FLOAT,
+  EXPR_CHAR,
+  EXPR_STRING,
+  EXPR_IDENT,
+  EXPR_UNARY,
+  EXPR_POSTFIX,
+  EXPR_CAST,
+  EXPR_BINARY,
+  EXPR_ASSIGN,
+  EXPR_TERNARY,
+  EXPR_CALL,
+  EXPR_INDEX,
+  EXPR_LIST,   // {1, 2, 3} ilk değer listesi
+  EXPR_SIZEOF, // op tür adıdır; yoksa left ifadedir
+  EXPR_MEMBER, // left.text ya da left->text, op "." veya "->"
+  EXPR_COMMA,  // döngü başlığındaki "i++, j--"
+} ExprKind;
+
+/* C işleç öncelikleri, küçükten büyüğe. */
+enum {
+  PREC_COMMA = 1,
+  PREC_ASSIGN,
+  PREC_TERNARY,
+  PREC_OR,
+  PREC_AND,
+  PREC_BITOR,
+  PREC_BITXOR,
+  PREC_BITAND,
+  PREC_EQUALITY,
+  PREC_RELATIONAL,
+  PREC_SHIFT,
+  PREC_ADDITIVE,
+  PREC_MULTIPLICATIVE,
+  PREC_UNARY,
+  PREC_POSTFIX,
+  PREC_PRIMARY,
+};
+
+typedef struct Expr {
+  ExprKind kind;
+  const char *op;   // işleç, EXPR_CAST için hedef tür
+  const char *text; // tanımlayıcı adı ya da kaynaktaki hazır değer
+  long long intValue;
+  double floatValue;
+  struct Expr *left, *right, *third;
+  struct Expr **args;
+  int argCount;
+} Expr;
+
+typedef struct {
+  const char *name;
+  int pointerDepth;
+  Expr *arraySize;
+  Expr *init;
+} Declarator;
+
+typedef struct {
+  const char *type; // NULL: bildirim yok
+  Declarator *items;
+  int count;
+} Declaration;
+
+typedef struct AstBlock {
+  struct AstBlock *next;
+  size_t used;
+  size_t size;
+  unsigned char data[];
+} AstBlock;
+
+/* Düğüm metninin ayrıştırılmış hali. Metin değişene kadar önbellekte kalır;
+ * tüm parçaları tek bir bölgeden ayrılır ve birlikte serbest bırakılır. */
+typedef struct NodeAst {
+  AstBlock *arena;
+  char error[128];        // sözdizimi hatası
+  char compileError[128]; // son derlemede bulunan anlamsal hata
+
+  Expr *expr; // koşul, ifade ya da dönüş değeri
+  Declaration decl;
+  bool isFor;
+  Expr *init, *step;
+  Expr **args; // İşlem ifadeleri, Giriş/Çıkış argümanları
+  int argCount;
+
+  int *declared; // bildirilen adların sembol numaraları
+  int declaredCount;
+  int *used; // kullanılan değişken adları
+  int usedCount;
+} NodeAst;
+
+
+/* Otomatik yerleşimin bulduğu bağlantı yolu; uçlar o andaki düğüm
+ * merkezleridir. Uçlardan biri yerinden oynarsa yol kullanılmaz. */
+typedef struct {
+  Vector2 *points;
+  int count;
+} LinkRoute;
+
+/* Her karede dokunulmayan veriler: metin, renk ve bağlantılar. */
+typedef struct {
   char *text;
+  NodeAst *ast; // NULL: metin henüz ayrıştırılmadı
+  float textWidth;
   Color instanceColor;
-  bool isSelected;
-  bool isEditing;
-  bool editable;
-  struct Node *next;
-  struct Node *alt_next;
-  unsigned int id;
-} Node;
-
-static Node *nodes = NULL;
-static bool *visitedNodes = NULL;
-static int nodeCount = 0;
+  int next;
+  int alt_next;
+  int reachIn; // ulaşılabilir düğümlerden gelen bağlantı sayısı
+  LinkRoute route[2]; // next ve alt_next için
+} NodeCold;
+
+/* Düğümler paralel diziler halinde tutulur; isabet testi, çizim ve yerleşim
+ * döngüleri yalnızca ihtiyaç duydukları sıkışık dizileri tarar. Bağlantılar
+ * indeks olarak saklanır, düğümün kimliği dizideki sırasıdır. */
+typedef struct {
+  int count;
+  int capacity;
+
+  float *posX, *posY;
+  float *minX, *minY, *maxX, *maxY;
+  unsigned char *type;
+  unsigned char *flags;
+
+  NodeCold *cold;
+  bool *visited;
+
+  int *visible; // son CullNodes çağrısında görüş alanına giren düğümler
+  int visibleCount;
+} NodeStore;
+
+static NodeStore nodes = {0};
+
+/* Kopyalanan düğümler; bağlantılar panodaki sıraya göre indekslenir. */
+typedef struct {
+  int count;
+  NodeType *type;
+  Vector2 *position;
+  NodeCold *cold;
+  Vector2 center;
+} NodeClipboard;
+
+static NodeClipboard clipboard = {0};
+
+typedef struct {
+  char *name;
+  bool builtin;
+  int declCount; // ulaşılabilir düğümlerdeki bildirim sayısı
+} Symbol;
+
+/* Sürekli doğrulama durumu. Ulaşılabilirlik ve bildirim sayıları bağlantı ve
+ * metin değişikliklerinde yalnızca etkilenen bölge için güncellenir; silme ve
+ * geri alma gibi indeksleri kaydıran işlemler bir sonraki karede tam yeniden
+ * hesaplamayı ister. */
+typedef struct {
+  bool rebuild;
+  unsigned version; // her yapısal değişiklikte artar
+
+  Symbol *symbols;
+  int symbolCount;
+  int *buckets; // açık adresli ad → sembol tablosu, -1 boş
+  int bucketCount;
+
+  int *queue; // yeniden hesaplanan bölge
+  int *internal; // bölge içinden gelen bağlantı sayısı
+  int *work;
+  unsigned *stamp;
+  unsigned epoch;
+  int scratchCapacity;
+} Validation;
+
+static Validation validation = {.rebuild = true};
+
+#define JOURNAL_MAX_ENTRIES 1024
+#define JOURNAL_MAX_BYTES (8 * 1024 * 1024)
+
+typedef struct {
+  unsigned char *data;
+  size_t size;
+  size_t capacity;
+  size_t pos; // okuma konumu
+} ByteBuffer;
+
+typedef enum {
+  JOURNAL_ADD,
+  JOURNAL_DELETE,
+  JOURNAL_MOVE,
+  JOURNAL_LINK,
+  JOURNAL_TEXT,
+  JOURNAL_LAYOUT,
+} JournalOpKind;
+
+typedef struct {
+  JournalOpKind kind;
+  int index; // ADD: eklenen ilk düğüm, LINK/TEXT: değişen düğüm
+  int count; // ADD/DELETE/MOVE/LAYOUT: düğüm sayısı
+  bool alt;
+  int before, after; // LINK: eski ve yeni hedef
+  Vector2 delta;     // MOVE
+  ByteBuffer payload;
+} JournalEntry;
+
+/* Halka tampon: [0, cursor) geri alınabilir, [cursor, count) yinelenebilir. */
+typedef struct {
+  JournalEntry entries[JOURNAL_MAX_ENTRIES];
+  int head;
+  int count;
+  int cursor;
+  size_t bytes;
+} Journal;
+
+static Journal journal = {0};
+
+#define CONSOLE_CAPACITY (64 * 1024)
+#define CONSOLE_READ_BUDGET (16 * 1024) // kare başına okunacak en fazla bayt
+#define CONSOLE_HEIGHT 200
+
+typedef struct {
+  char buffer[CONSOLE_CAPACITY]; // halka tampon
+  int start;
+  int length;
+
+  char input[256];
+  int inputLength;
+
+  char *pending; // boru dolduğunda yazılamayan girdi
+  int pendingLength;
+
+  pid_t pid;
+  int toChild;
+  int fromChild;
+
+  bool visible;
+  bool focused;
+} RunConsole;
+
+static RunConsole console = {.toChild = -1, .fromChild = -1};
 
 typedef struct {
   char *name;
   char *type;
 } Variable;
 
-static Variable vars[MAX_VARIABLES];
-static int var_count = 0;
+typedef struct {
+  int start; // Başla düğümü
+  char *name;
+  char *returnType;
+  char *params;
+  char *signature;
+  bool isMain;
+} FunctionInfo;
+
+/* Kod üretimi sırasında bir düğümde bulunan anlamsal hata. */
+typedef struct {
+  int index;
+  char *message;
+} NodeError;
+
+/* Kod üretimi fonksiyon başına ayrı bağlamla yapılır; böylece fonksiyonlar
+ * aynı anda farklı iş parçacıklarında üretilebilir. */
+typedef struct {
+  bool *visited;
+  Variable vars[MAX_VARIABLES];
+  int var_count;
+
+  const FunctionInfo *function;
+  const FunctionInfo *functions;
+  int functionCount;
+  const bool *labeled; // goto ile atlanabilen düğümler etiket alır
+
+  NodeError *errors;
+  int errorCount;
+} CodegenContext;
+
+typedef struct {
+  const FunctionInfo *function;
+  const FunctionInfo *functions;
+  int functionCount;
+  const bool *labeled;
+  const char *prelude; // içerme satırları ve tüm fonksiyonların bildirimleri
+
+  NodeError *diagnostics; // varsa derleyici hiç çalıştırılmaz
+  int diagnosticCount;
+
+  char *source;
+  unsigned long long hash;
+  unsigned long long cachedHash;
+  char objectPath[256];
+  bool reused;
+  bool failed;
+  char *errors;
+} CompileJob;
+
+/* Önceki çalıştırmalarda derlenen fonksiyonlar; kaynak özeti aynı kalırsa
+ * nesne dosyası yeniden kullanılır. */
+typedef struct {
+  char *name;
+  unsigned long long hash;
+} CompiledFunction;
+
+static CompiledFunction *compiledFunctions = NULL;
+static int compiledCount = 0;
+static pthread_mutex_t tccLock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+  void (*func)(void *arg);
+  void *arg;
+} PoolTask;
+
+typedef struct {
+  pthread_t *threads;
+  int threadCount;
+
+  PoolTask *tasks; // halka kuyruk
+  int head;
+  int tail;
+  int capacity;
+  int pending; // kuyrukta ya da çalışmakta olan iş sayısı
+  bool stopping;
 
-static Node *linkingNode = NULL;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t idle;
+} ThreadPool;
+
+static ThreadPool threadPool;
+/* Yerleşim işleri ayrı havuzdadır; derleme, kuyrukta bekleyen bileşenleri
+ * beklemeden biter. */
+static ThreadPool layoutPool;
+
+typedef struct LayoutJob LayoutJob;
+
+/* Bağlı bir alt çizge; her biri havuzdaki ayrı bir işte yerleştirilir. */
+typedef struct {
+  LayoutJob *job;
+  int *members; // düğüm indeksleri
+  int memberCount;
+  bool hasStart;
+
+  Vector2 *local; // bileşenin sol üst köşesine göre düğüm merkezleri
+  Vector2 size;
+} LayoutComponent;
+
+/* Yerleşim ana iş parçacığında alınan bir anlık görüntü üzerinde arka planda
+ * çalışır; sonuç bir sonraki karelerde uygulanır. */
+struct LayoutJob {
+  int count;
+  unsigned version; // başladığındaki çizge sürümü
+  int *next, *alt;
+  unsigned char *type;
+  Vector2 *size;
+  Vector2 *position;
+  bool *seeds; // NULL: tüm çizge
+
+  bool *placed;
+  int *localIndex;
+  Vector2 *target;
+  LinkRoute *routes; // düğüm başına iki
+  int *members;
+  LayoutComponent *components;
+  int componentCount;
+
+  int remaining; // bitmemiş bileşen işleri
+  bool done;
+  bool threaded;
+  pthread_mutex_t lock;
+  pthread_cond_t finished;
+  pthread_t thread;
+};
+
+typedef struct {
+  LayoutJob *job; // NULL: arka planda yerleşim yok
+
+  int *animIndex; // hedefine kaymakta olan düğümler
+  Vector2 *animTarget;
+  int animCount;
+  int animCapacity;
+} AutoLayout;
+
+static AutoLayout autoLayout = {0};
+
+typedef struct {
+  int codepoint;
+  Rectangle source; // atlastaki yeri; boş glifler için genişlik 0
+  float offsetX, offsetY, advanceX;
+} SdfGlyph;
+
+typedef struct {
+  Vector2 corners[4]; // sol üst, sol alt, sağ alt, sağ üst
+  Rectangle source;
+  Color color;
+} TextQuad;
+
+/* Glifler ilk görüldüklerinde mesafe alanı olarak taranıp büyüyen bir atlasa
+ * eklenir. Yazılar çizilmez, kuyruğa alınır; kuyruk katman sonunda tek
+ * seferde basılır. */
+typedef struct {
+  unsigned char *fileData;
+  int fileSize;
+
+  SdfGlyph *glyphs;
+  int glyphCount;
+  int *buckets; // açık adresli kod noktası → glif tablosu, -1 boş
+  int bucketCount;
+
+  unsigned char *pixels; // gri-alfa atlas, dokunun kaynağı
+  int width, height;
+  int penX, penY, rowHeight; // sıradaki boş yer
+  int dirtyTop, dirtyBottom; // dokuya henüz yüklenmemiş satırlar
+  bool resized;
+  Texture2D texture;
+  Shader shader;
+
+  TextQuad *quads;
+  int quadCount;
+  int quadCapacity;
+  Rectangle clip;
+  bool clipping;
+} SdfFont;
+
+static int linkingIndex = NODE_NONE;
 static bool linkingAlt = false;
 static bool isLinking = false;
 
 static bool draggingFromMenu = false;
 static NodeType draggingType;
 
-static Node *selectedNode = NULL;
-static int selectedIndex = -1;
+static int hoveredIndex = NODE_NONE;
 
-static Vector2 dragOffset = {0};
+static Vector2 dragAnchor = {0};
+static Vector2 dragTotal = {0};
 static bool isDragging = false;
 
-static Node *editingNode = NULL;
+static Vector2 boxStart = {0};
+static bool isBoxSelecting = false;
+
+static int editingIndex = NODE_NONE;
 static bool isEditing = false;
+static char *editingStartText = NULL;
 
 void DrawGridD(int sqrSide, int bigSqr, int bigSqrCW, int bigSqrCH,
                Color sqrColor, Color bigSqrColor);
 
-Node CreateNode(NodeType type, Vector2 pos);
-void AddNode(NodeType type, Vector2 pos);
-void DeleteNode(int index);
-
-void DrawNode(Node *node, Font font);
-void DrawNodePreview(NodeType type, Font font, Vector2 pos);
-void DrawLink(Node *node, Font font);
+int AddNode(NodeType type, Vector2 pos);
+void ReserveNodes(int capacity);
+Vector2 GetNodePosition(int index);
+void SetNodePosition(int index, Vector2 pos);
+void SetNodeText(int index, char *text);
+void FreeNodeCold(NodeCold *cold);
+void SetNodeLink(int index, bool alt, int target);
+void UpdateNodeBounds(int index);
+void RefreshDirtyNodes(SdfFont *font);
+NodeAst *GetNodeAst(int index);
+NodeAst *ParseNode(int index);
+void FreeNodeAst(NodeAst *ast);
+const char *GetNodeError(int index);
+
+int InternSymbol(const char *name);
+void ValidateNodeAdded(int index);
+void ValidateLinkChanged(int index, int before, int after);
+void ValidateTextChanging(int index);
+void ValidateNodeParsed(int index);
+void UpdateValidation(void);
+const char *GetNodeIssue(int index);
+const char *GetLinkIssue(int index);
+void InitNodeKernels(void);
+int HitTestNodes(Vector2 point);
+int QueryNodesInRect(Rectangle rect, bool contain, int *out);
+void CullNodes(Rectangle view);
+bool IsLinkVisible(int from, bool alt, Rectangle view);
+
+void SetAllNodesSelected(bool selected);
+void SelectNodesInRect(Rectangle rect);
+void MoveSelectedNodes(Vector2 delta);
+int DeleteSelectedNodes(void);
+void CopySelectedNodes(NodeClipboard *clip);
+int PasteNodes(const NodeClipboard *clip, Vector2 offset);
+void FreeClipboard(NodeClipboard *clip);
+
+void JournalRecordAdd(int first, int count);
+void JournalRecordDelete(void);
+void JournalRecordMove(Vector2 delta);
+void JournalRecordLink(int index, bool alt, int before, int after);
+void JournalRecordText(int index, const char *before, const char *after);
+bool Undo(void);
+bool Redo(void);
+
+void ConsoleAppend(const char *text, int length);
+char ConsoleCharAt(int k);
+void ConsolePrint(const char *text);
+void ConsoleClear(void);
+bool ConsoleRun(const char *path);
+void ConsoleStop(void);
+void ConsoleFlushInput(void);
+void ConsolePoll(void);
+void ConsoleHandleKeys(void);
+Rectangle GetConsoleRect(void);
+void DrawConsole(SdfFont *font);
+
+void DrawNode(int index, SdfFont *font);
+void DrawNodeShape(NodeType type, Vector2 pos, const char *text,
+                   float textWidth, Color fill, Color outline, SdfFont *font);
+void DrawNodePreview(NodeType type, SdfFont *font, Vector2 pos);
+void DrawLink(int index, SdfFont *font);
+Vector2 DrawLinkPath(int index, bool alt, int target);
 void DrawArrow(Vector2 start, Vector2 end, Color color);
-void DrawLabelOnLine(Vector2 start, Vector2 end, const char *text, Font font,
-                     Color color);
-Vector2 GetClosestEdge(Node *startNode, Node *destNode, Font font);
-
-void DrawMenu(Color back, Font font);
-
-Font LoadFontT();
-char *CompileCode(Node *node, char *textBefore);
-char *CompileCodeToEXE(Node *node, char *fileName);
+void DrawLabelOnLine(Vector2 start, Vector2 end, const char *text,
+                     SdfFont *font, Color color);
+Vector2 GetClosestEdge(Vector2 start, int destIndex);
+
+void DrawMenu(Color back, SdfFont *font);
+
+SdfFont *LoadFontT(void);
+void UnloadFontT(SdfFont *font);
+Vector2 MeasureTextSDF(SdfFont *font, const char *text, float fontSize,
+                       float spacing);
+void DrawTextSDF(SdfFont *font, const char *text, Vector2 position,
+                 float fontSize, float spacing, Color tint);
+void DrawTextProSDF(SdfFont *font, const char *text, Vector2 position,
+                    Vector2 origin, float rotation, float fontSize,
+                    float spacing, Color tint);
+void SetTextClipSDF(SdfFont *font, const Rectangle *clip);
+void FlushTextSDF(SdfFont *font);
+char *CompileCode(CodegenContext *ctx, int index, char *textBefore);
+bool CompileCodeToEXE(char *fileName);
+bool IsIdentifierChar(char c);
+bool ContainsIdentifier(const char *text, const char *name);
+bool ParseFunctionSignature(const char *text, FunctionInfo *fn);
+void FreeFunctionInfo(FunctionInfo *fn);
+
+void ReportNodeError(CodegenContext *ctx, int index, const char *format, ...);
+ValueType ValueTypeFromName(const char *type);
+ValueType CheckExpr(CodegenContext *ctx, int index, const Expr *e);
+void CheckAssignable(CodegenContext *ctx, int index, ValueType target,
+                     ValueType value);
+void CheckDeclaration(CodegenContext *ctx, int index, const Declaration *decl,
+                      bool scoped);
+void CheckFormatArgs(CodegenContext *ctx, int index, Expr **args,
+                     int argCount);
+char *ExprToC(const Expr *e);
+char *ConditionToC(const Expr *cond, bool negate);
+char *DeclarationToC(const Declaration *decl);
+
+void StartLayout(bool selectionOnly);
+void PollLayout(void);
+void AnimateLayout(float dt);
+void FinishLayoutAnimation(void);
+void StopLayout(void);
+bool IsRouteValid(int index, int target, const LinkRoute *route);
+
+void ThreadPoolInit(ThreadPool *pool, int threadCount);
+void ThreadPoolSubmit(ThreadPool *pool, void (*func)(void *), void *arg);
+void ThreadPoolWait(ThreadPool *pool);
+void ThreadPoolShutdown(ThreadPool *pool);
 char *append_string(char *base, const char *addition);
 
 void BackspaceUTF8(char *text) {
@@ -124,20 +656,49 @@ void BackspaceUTF8(char *text) {
   text[i] = '\0';
 }
 
-Node *IfTypeExist(NodeType type) {
-  for (int i = 0; i < nodeCount; i++) {
-    if (nodes[i].type == type)
-      return &nodes[i];
-  }
-  return NULL;
+void BeginEditing(int index) {
+  editingIndex = index;
+  editingStartText = strdup(nodes.cold[index].text);
+  nodes.flags[index] |= NODE_FLAG_EDITING;
+  isEditing = true;
+}
+
+/* Bir düzenleme oturumundaki tüm tuş vuruşları tek kayıt olarak saklanır. */
+void EndEditing(void) {
+  if (!isEditing)
+    return;
+
+  JournalRecordText(editingIndex, editingStartText,
+                    nodes.cold[editingIndex].text);
+  free(editingStartText);
+  editingStartText = NULL;
+
+  nodes.flags[editingIndex] &= ~NODE_FLAG_EDITING;
+  isEditing = false;
+  editingIndex = NODE_NONE;
+}
+
+/* Sürükleme boyunca yapılan hareketler tek kayıt olarak saklanır. */
+void EndDrag(void) {
+  if (!isDragging)
+    return;
+
+  JournalRecordMove(dragTotal);
+  dragTotal = Vector2Zero();
+  isDragging = false;
 }
 
 int main(void) {
   setlocale(LC_ALL, "Turkish");
+  signal(SIGPIPE, SIG_IGN); // program kapanınca stdin'e yazmak bizi öldürmesin
 
   InitWindow(800, 600, "DoraNode test 1.5");
   SetWindowState(FLAG_WINDOW_RESIZABLE);
-  Font font = LoadFontT();
+  SdfFont *font = LoadFontT();
+  InitNodeKernels();
+  long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+  ThreadPoolInit(&threadPool, cpuCount > 0 ? cpuCount : 1);
+  ThreadPoolInit(&layoutPool, cpuCount > 0 ? cpuCount : 1);
   Camera2D cam = (Camera2D){Vector2Zero(), Vector2Zero(), 0, 1};
   cam.offset = (Vector2){GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f};
 
@@ -160,11 +721,30 @@ int main(void) {
       runPosButton = (Vector2){GetScreenWidth() - 53, 0};
     }
 
+    RefreshDirtyNodes(font);
+    UpdateValidation();
+    PollLayout();
+    AnimateLayout(GetFrameTime());
+    ConsolePoll();
+
+    bool shiftDown = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT);
+    bool ctrlDown =
+        IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    bool overConsole =
+        console.visible && CheckCollisionPointRec(mousePos, GetConsoleRect());
+    bool overButtons = (mousePos.x > runPosButton.x - 10 && mousePos.y < 63) ||
+                       (mousePos.x > trashPos.x - 10 &&
+                        mousePos.y > trashPos.y - 10) ||
+                       overConsole;
+
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+      console.focused = overConsole;
+
     static double lastClickTime = 0;
     double currentTime = GetTime();
     bool doubleClick = false;
     if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-      if (selectedNode != NULL) {
+      if (hoveredIndex != NODE_NONE) {
         if (currentTime - lastClickTime < 0.3) {
           doubleClick = true;
         }
@@ -172,9 +752,21 @@ int main(void) {
       }
     }
 
-    if (doubleClick && selectedNode != NULL && selectedNode->editable) {
-      editingNode = selectedNode;
-      isEditing = true;
+    if (doubleClick && hoveredIndex != NODE_NONE &&
+        (nodes.flags[hoveredIndex] & NODE_FLAG_EDITABLE)) {
+      BeginEditing(hoveredIndex);
+    }
+
+    if (ctrlDown && !isDragging && !isBoxSelecting &&
+        !(console.visible && console.focused) &&
+        (IsKeyPressed(KEY_Z) || IsKeyPressed(KEY_Y))) {
+      EndEditing();
+      bool changed = IsKeyPressed(KEY_Y) || shiftDown ? Redo() : Undo();
+      if (changed) {
+        hoveredIndex = NODE_NONE;
+        isLinking = false;
+        linkingIndex = NODE_NONE;
+      }
     }
 
     if (isEditing) {
@@ -189,92 +781,158 @@ int main(void) {
           memcpy(utf8, converted, utf8Size);
           utf8[utf8Size] = '\0';
 
-          editingNode->text = append_string(editingNode->text, utf8);
+          SetNodeText(editingIndex,
+                      append_string(nodes.cold[editingIndex].text, utf8));
         }
         key = GetCharPressed(); // birden fazla tuş varsa sırayla al
       }
 
       if (IsKeyPressed(KEY_BACKSPACE)) {
-        BackspaceUTF8(editingNode->text);
+        BackspaceUTF8(nodes.cold[editingIndex].text);
+        SetNodeText(editingIndex, nodes.cold[editingIndex].text);
       }
 
-      if (selectedNode != editingNode) {
-        isEditing = false;
-        editingNode = NULL;
+      if (hoveredIndex != editingIndex) {
+        EndEditing();
+      }
+    } else if (console.visible && console.focused) {
+      ConsoleHandleKeys();
+      if (IsKeyPressed(KEY_ESCAPE))
+        console.focused = false;
+    } else {
+      bool deleted = false;
+      if (IsKeyPressed(KEY_DELETE)) {
+        JournalRecordDelete();
+        deleted = DeleteSelectedNodes() > 0;
+      } else if (IsKeyPressed(KEY_GRAVE) || IsKeyPressed(KEY_F1)) {
+        console.visible = !console.visible;
+      } else if (ctrlDown && IsKeyPressed(KEY_L)) {
+        StartLayout(shiftDown);
+      } else if (ctrlDown && IsKeyPressed(KEY_A)) {
+        SetAllNodesSelected(true);
+      } else if (ctrlDown && IsKeyPressed(KEY_C)) {
+        CopySelectedNodes(&clipboard);
+      } else if (ctrlDown && IsKeyPressed(KEY_X)) {
+        CopySelectedNodes(&clipboard);
+        JournalRecordDelete();
+        deleted = DeleteSelectedNodes() > 0;
+      } else if (ctrlDown && IsKeyPressed(KEY_V) && clipboard.count > 0) {
+        Vector2 offset = Vector2Subtract(worldMouse, clipboard.center);
+        JournalRecordAdd(PasteNodes(&clipboard, offset), clipboard.count);
+      } else if (ctrlDown && IsKeyPressed(KEY_D)) {
+        NodeClipboard duplicate = {0};
+        CopySelectedNodes(&duplicate);
+        JournalRecordAdd(
+            PasteNodes(&duplicate, (Vector2){GRID_SQR_SIDE, GRID_SQR_SIDE}),
+            duplicate.count);
+        FreeClipboard(&duplicate);
       }
-    }
-
-    if (mousePos.x > MENU_WIDTH && !isDragging && !draggingFromMenu &&
-        nodeCount > 0) {
-      for (int i = nodeCount - 1; i >= 0; i--) {
-        Node *node = &nodes[i];
-        float width = 100 + MeasureTextEx(font, (char *)node->text, 20, 1).x,
-              height = 50;
-
-        Rectangle rect = {node->position.x - width / 2,
-                          node->position.y - height / 2, width, height};
 
-        if (CheckCollisionPointRec(worldMouse, rect)) {
-          selectedNode = node;
-          selectedIndex = i;
-          break;
-        } else {
-          selectedNode = NULL;
-          selectedIndex = -1;
-        }
+      if (deleted) {
+        hoveredIndex = NODE_NONE;
+        isDragging = false;
+        isLinking = false;
+        linkingIndex = NODE_NONE;
       }
     }
 
+    if (mousePos.x > MENU_WIDTH && !overConsole && !isDragging &&
+        !isBoxSelecting && !draggingFromMenu && nodes.count > 0) {
+      hoveredIndex = HitTestNodes(worldMouse);
+    }
+
     if (mousePos.x > trashPos.x - 10 && mousePos.y > trashPos.y - 10 &&
-        selectedNode != NULL) {
-      DeleteNode(selectedIndex);
-      selectedNode = NULL;
-      selectedIndex = -1;
+        isDragging) {
+      EndEditing();
+      EndDrag();
+      JournalRecordDelete();
+      DeleteSelectedNodes();
+      hoveredIndex = NODE_NONE;
     }
 
-    if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT) && selectedNode != NULL) {
+    if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT) &&
+        hoveredIndex != NODE_NONE) {
       isLinking = true;
-      linkingNode = selectedNode;
+      linkingIndex = hoveredIndex;
 
-      if (linkingNode->next != NULL && (linkingNode->type == NODE_DECISION ||
-                                        linkingNode->type == NODE_LOOP)) {
+      NodeType linkingType = nodes.type[linkingIndex];
+      if (nodes.cold[linkingIndex].next != NODE_NONE &&
+          (linkingType == NODE_DECISION || linkingType == NODE_LOOP)) {
         linkingAlt = true;
       } else {
         linkingAlt = false;
       }
     } else if (IsMouseButtonReleased(MOUSE_BUTTON_RIGHT) && isLinking) {
-      if (selectedNode != NULL && selectedNode->type != NODE_START) {
-        if (linkingAlt)
-          linkingNode->alt_next = selectedNode;
-        else
-          linkingNode->next = selectedNode;
+      if (hoveredIndex != NODE_NONE &&
+          nodes.type[hoveredIndex] != NODE_START) {
+        NodeCold *cold = &nodes.cold[linkingIndex];
+        JournalRecordLink(linkingIndex, linkingAlt,
+                          linkingAlt ? cold->alt_next : cold->next,
+                          hoveredIndex);
+        SetNodeLink(linkingIndex, linkingAlt, hoveredIndex);
       }
 
       isLinking = false;
       linkingAlt = false;
-      linkingNode = NULL;
+      linkingIndex = NODE_NONE;
     }
 
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && selectedNode != NULL) {
-      isDragging = true;
-      dragOffset = Vector2Subtract(selectedNode->position, worldMouse);
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && !draggingFromMenu &&
+        mousePos.x > MENU_WIDTH && !overButtons) {
+      if (hoveredIndex != NODE_NONE) {
+        bool selected = nodes.flags[hoveredIndex] & NODE_FLAG_SELECTED;
+        if (shiftDown) {
+          nodes.flags[hoveredIndex] ^= NODE_FLAG_SELECTED;
+        } else if (!selected) {
+          SetAllNodesSelected(false);
+          nodes.flags[hoveredIndex] |= NODE_FLAG_SELECTED;
+        }
+
+        if (nodes.flags[hoveredIndex] & NODE_FLAG_SELECTED) {
+          FinishLayoutAnimation();
+          isDragging = true;
+          dragAnchor = worldMouse;
+          dragTotal = Vector2Zero();
+        }
+      } else {
+        if (!shiftDown)
+          SetAllNodesSelected(false);
+        isBoxSelecting = true;
+        boxStart = worldMouse;
+      }
     }
 
     if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) &&
         mousePos.x > runPosButton.x - 10 && mousePos.y < 63) {
-      CompileCodeToEXE(IfTypeExist(NODE_START), "temp");
+      ConsoleStop();
+      ConsoleClear();
+      if (CompileCodeToEXE("temp"))
+        ConsoleRun("./temp");
+      console.visible = true;
     }
 
+    Rectangle selectionBox = {fminf(boxStart.x, worldMouse.x),
+                              fminf(boxStart.y, worldMouse.y),
+                              fabsf(worldMouse.x - boxStart.x),
+                              fabsf(worldMouse.y - boxStart.y)};
+
     if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
-      isDragging = false;
+      EndDrag();
+      if (isBoxSelecting) {
+        SelectNodesInRect(selectionBox);
+        isBoxSelecting = false;
+      }
     }
 
-    if (isDragging && selectedNode != NULL) {
-      selectedNode->position = Vector2Add(worldMouse, dragOffset);
+    if (isDragging) {
+      Vector2 delta = Vector2Subtract(worldMouse, dragAnchor);
+      MoveSelectedNodes(delta);
+      dragTotal = Vector2Add(dragTotal, delta);
+      dragAnchor = worldMouse;
     }
     if (draggingFromMenu && mousePos.x > MENU_WIDTH) {
       if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-        AddNode(draggingType, worldMouse);
+        JournalRecordAdd(AddNode(draggingType, worldMouse), 1);
 
         draggingFromMenu = false;
       }
@@ -291,26 +949,51 @@ int main(void) {
               GRID_SQR_COLOR, GRID_BIG_COLOR);
 
     if (isLinking) {
-      if (selectedNode != NULL && selectedNode != linkingNode) {
-        DrawArrow(linkingNode->position,
-                  GetClosestEdge(linkingNode, selectedNode, font), ORANGE);
+      if (hoveredIndex != NODE_NONE && hoveredIndex != linkingIndex) {
+        DrawArrow(GetNodePosition(linkingIndex),
+                  GetClosestEdge(GetNodePosition(linkingIndex), hoveredIndex),
+                  ORANGE);
       } else {
-        DrawArrow(linkingNode->position, worldMouse, ORANGE);
+        DrawArrow(GetNodePosition(linkingIndex), worldMouse, ORANGE);
       }
     }
 
-    for (int i = 0; i < nodeCount; i++) {
-      DrawLink(&nodes[i], font);
-      DrawNode(&nodes[i], font);
+    Vector2 viewMin = GetScreenToWorld2D(Vector2Zero(), cam),
+            viewMax = GetScreenToWorld2D(
+                (Vector2){GetScreenWidth(), GetScreenHeight()}, cam);
+    Rectangle view = {viewMin.x, viewMin.y, viewMax.x - viewMin.x,
+                      viewMax.y - viewMin.y};
+    CullNodes(view);
+
+    for (int i = 0; i < nodes.count; i++) {
+      NodeCold *cold = &nodes.cold[i];
+      if ((cold->next != NODE_NONE && IsLinkVisible(i, false, view)) ||
+          (cold->alt_next != NODE_NONE && IsLinkVisible(i, true, view)))
+        DrawLink(i, font);
+    }
+
+    for (int i = 0; i < nodes.visibleCount; i++) {
+      DrawNode(nodes.visible[i], font);
     }
 
     if (draggingFromMenu) {
       DrawNodePreview(draggingType, font, worldMouse);
     }
 
+    if (isBoxSelecting) {
+      DrawRectangleRec(selectionBox, Fade(ORANGE, 0.15f));
+      DrawRectangleLinesEx(selectionBox, 1 / cam.zoom, ORANGE);
+    }
+
+    FlushTextSDF(font); // kanvas yazıları, arayüz panellerinin altında
     EndMode2D();
 
     DrawMenu(MENU_BACK_COLOR, font);
+    DrawConsole(font);
+    if (autoLayout.job)
+      DrawTextSDF(font, "Yerleşim hesaplanıyor...",
+                  (Vector2){MENU_WIDTH + 10, 10}, 20, 1, DARKGRAY);
+    FlushTextSDF(font);
 
     DrawRectangle(runPosButton.x - 10, runPosButton.y, 63, 58, GREEN);
     DrawTextureEx(runButtonTex, Vector2Add(runPosButton, (Vector2){0, 5}), 0,
@@ -322,13 +1005,17 @@ int main(void) {
     EndDrawing();
   }
 
-  UnloadFont(font);
+  ConsoleStop();
+  StopLayout();
+  ThreadPoolShutdown(&threadPool);
+  ThreadPoolShutdown(&layoutPool);
+  UnloadFontT(font);
   UnloadTexture(trashIcon);
 
   CloseWindow();
 }
 
-void DrawMenu(Color back, Font font) {
+void DrawMenu(Color back, SdfFont *font) {
   DrawRectangle(0, 0, MENU_WIDTH, GetScreenHeight(), back);
   DrawRectangleLines(0, 0, MENU_WIDTH, GetScreenHeight(), BLACK);
 
@@ -342,7 +1029,7 @@ void DrawMenu(Color back, Font font) {
     for (NodeType i = NODE_START; i <= NODE_LOOP; i++) {
       Vector2 pos = Vector2Add(startPos, Vector2Scale(incrementPos, i));
       Rectangle rect = {pos.x - 50, pos.y - 25, 100, 50};
-      if (selectedNode == NULL && !draggingFromMenu &&
+      if (hoveredIndex == NODE_NONE && !draggingFromMenu &&
           CheckCollisionPointRec(mousePos, rect) &&
           IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
         draggingFromMenu = true;
@@ -353,541 +1040,4963 @@ void DrawMenu(Color back, Font font) {
   }
 }
 
-Font LoadFontT() {
+/* Mesafe alanında 0.5 glifin kenarıdır. Kenar, ekrandaki bir pikselin alanda
+ * kapladığı değişim kadar yumuşatıldığından her yakınlaştırmada keskin
+ * kalır. Alanın düz olduğu yerlerde genişlik sıfır olur; smoothstep'in
+ * kenarları eşit olamayacağından alttan sınırlanır. */
+const char *SDF_FRAGMENT_SHADER =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "  float distance = texture(texture0, fragTexCoord).a - 0.5;\n"
+    "  float width = length(vec2(dFdx(distance), dFdy(distance)));\n"
+    "  width = max(width, 1e-4);\n"
+    "  float alpha = smoothstep(-width, width, distance);\n"
+    "  finalColor = vec4(fragColor.rgb, fragColor.a * alpha);\n"
+    "}\n";
+
+/* Yazı tipi dosyası bellekte tutulur; hiçbir glif önceden taranmaz. */
+SdfFont *LoadFontT(void) {
+  SdfFont *font = calloc(1, sizeof(SdfFont));
+  if (!font) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
 
-  int codepoints[] = {
-      32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,
-      46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,
-      60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,  72,  73,
-      74,  75,  76,  77,  78,  79,  80,  81,  82,  83,  84,  85,  86,  87,
-      88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,  99,  100, 101,
-      102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115,
-      116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126,
+  font->fileData = LoadFileData("resources/OpenSans.ttf", &font->fileSize);
+  font->width = SDF_ATLAS_WIDTH;
+  font->height = SDF_ATLAS_HEIGHT;
+  font->pixels = calloc(font->width * font->height * 2, 1);
+  if (!font->pixels) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  font->penX = font->penY = 1;
+  font->dirtyTop = font->height;
+  font->resized = true; // doku ilk basışta oluşturulur
+  font->shader = LoadShaderFromMemory(NULL, SDF_FRAGMENT_SHADER);
 
-      199, 214, 220, 304, 286, 350, 231, 246, 252, 287, 305, 351};
+  return font;
+}
 
-  int codepointCount = sizeof(codepoints) / sizeof(codepoints[0]);
+#define GROW_ARRAY(array, capacity)                                            \
+  do {                                                                         \
+    void *grown = realloc((array), (capacity) * sizeof(*(array)));             \
+    if (!grown) {                                                              \
+      printf("Bellek tahsisi başarısız!\n");                                   \
+      exit(1);                                                                 \
+    }                                                                          \
+    (array) = grown;                                                           \
+  } while (0)
+
+void ReserveNodes(int capacity) {
+  if (capacity <= nodes.capacity)
+    return;
 
-  // Fontu yükle
-  Font font =
-      LoadFontEx("resources/OpenSans.ttf", 20, codepoints, codepointCount);
+  int newCapacity = nodes.capacity > 0 ? nodes.capacity : 64;
+  while (newCapacity < capacity)
+    newCapacity *= 2;
+
+  GROW_ARRAY(nodes.posX, newCapacity);
+  GROW_ARRAY(nodes.posY, newCapacity);
+  GROW_ARRAY(nodes.minX, newCapacity);
+  GROW_ARRAY(nodes.minY, newCapacity);
+  GROW_ARRAY(nodes.maxX, newCapacity);
+  GROW_ARRAY(nodes.maxY, newCapacity);
+  GROW_ARRAY(nodes.type, newCapacity);
+  GROW_ARRAY(nodes.flags, newCapacity);
+  GROW_ARRAY(nodes.cold, newCapacity);
+  GROW_ARRAY(nodes.visited, newCapacity);
+  GROW_ARRAY(nodes.visible, newCapacity);
+
+  nodes.capacity = newCapacity;
+}
 
-  return font;
+int AddNode(NodeType type, Vector2 pos) {
+  ReserveNodes(nodes.count + 1);
+
+  int index = nodes.count++;
+  nodes.posX[index] = pos.x;
+  nodes.posY[index] = pos.y;
+  nodes.type[index] = type;
+  nodes.flags[index] = NODE_FLAG_DIRTY | NODE_FLAG_EDITABLE;
+  nodes.cold[index] = (NodeCold){.text = strdup(NODE_TYPE_NAME[type]),
+                                 .ast = NULL,
+                                 .textWidth = 0,
+                                 .instanceColor = NODE_TYPE_COLOR[type],
+                                 .next = NODE_NONE,
+                                 .alt_next = NODE_NONE};
+  nodes.visited[index] = false;
+  UpdateNodeBounds(index);
+  ValidateNodeAdded(index);
+
+  return index;
 }
 
-void AddNode(NodeType type, Vector2 pos) {
-  Node newNode = CreateNode(type, pos);
+Vector2 GetNodePosition(int index) {
+  return (Vector2){nodes.posX[index], nodes.posY[index]};
+}
 
-  Node *newNodes = realloc(nodes, (nodeCount + 1) * sizeof(Node));
-  bool *newVisitedNodes = realloc(visitedNodes, (nodeCount + 1) * sizeof(bool));
-  if (!newNodes || !newVisitedNodes) {
-    printf("Bellek tahsisi başarısız!\n");
-    exit(1);
-  }
+void SetNodePosition(int index, Vector2 pos) {
+  nodes.posX[index] = pos.x;
+  nodes.posY[index] = pos.y;
+  UpdateNodeBounds(index);
+}
 
-  nodes = newNodes;
-  visitedNodes = newVisitedNodes;
+/* Metin yerinde değiştirildiyse de çağrılmalıdır; önbellekteki ağaç atılır. */
+void SetNodeText(int index, char *text) {
+  NodeCold *cold = &nodes.cold[index];
+  ValidateTextChanging(index);
+  if (cold->text != text)
+    free(cold->text);
+  cold->text = text;
+  FreeNodeAst(cold->ast);
+  cold->ast = NULL;
+  nodes.flags[index] |= NODE_FLAG_DIRTY;
+}
 
-  nodes[nodeCount] = newNode;
-  visitedNodes[nodeCount] = false;
-  nodeCount++;
+void FreeNodeCold(NodeCold *cold) {
+  free(cold->text);
+  FreeNodeAst(cold->ast);
+  free(cold->route[0].points);
+  free(cold->route[1].points);
+  cold->text = NULL;
+  cold->ast = NULL;
+  cold->route[0] = cold->route[1] = (LinkRoute){0};
 }
 
-Node CreateNode(NodeType type, Vector2 pos) {
-  Node node = {.type = type,
-               .position = pos,
-               .text = strdup(NODE_TYPE_NAME[type]),
-               .instanceColor = NODE_TYPE_COLOR[type],
-               .isSelected = false,
-               .isEditing = false,
-               .editable = (type != NODE_START && type != NODE_END),
-               .id = nodeCount};
-  return node;
+/* Düğüm şekli metin genişliğine göre büyür; DrawNode ile aynı ölçüler. */
+void UpdateNodeBounds(int index) {
+  float textWidth = nodes.cold[index].textWidth;
+  float width = fmaxf(100, 20 + textWidth), height = 50 + textWidth / 10;
+
+  nodes.minX[index] = nodes.posX[index] - width / 2;
+  nodes.maxX[index] = nodes.posX[index] + width / 2;
+  nodes.minY[index] = nodes.posY[index] - height / 2;
+  nodes.maxY[index] = nodes.posY[index] + height / 2;
 }
 
-void DeleteNode(int index) {
-  if (index < 0 || index >= nodeCount) {
-    printf("Geçersiz indeks!\n");
-    return;
+/* Metni değişen düğümler ölçülür ve yeniden ayrıştırılır; diğerlerinin
+ * ölçüsü ve ağacı önbellekten kullanılır. */
+void RefreshDirtyNodes(SdfFont *font) {
+  for (int i = 0; i < nodes.count; i++) {
+    if (nodes.flags[i] & NODE_FLAG_DIRTY) {
+      nodes.cold[i].textWidth =
+          MeasureTextSDF(font, nodes.cold[i].text, 20, 1).x;
+      nodes.flags[i] &= ~NODE_FLAG_DIRTY;
+      UpdateNodeBounds(i);
+    }
+    GetNodeAst(i);
   }
+}
 
-  Node *deletingNode = &nodes[index];
+/* Seçim üzerindeki toplu işlemler her biri tek geçişte çalışır. */
 
-  for (int i = 0; i < nodeCount; i++) {
-    if (nodes[i].next == deletingNode)
-      nodes[i].next = NULL;
-    if (nodes[i].alt_next == deletingNode)
-      nodes[i].alt_next = NULL;
+void SetAllNodesSelected(bool selected) {
+  for (int i = 0; i < nodes.count; i++) {
+    if (selected)
+      nodes.flags[i] |= NODE_FLAG_SELECTED;
+    else
+      nodes.flags[i] &= ~NODE_FLAG_SELECTED;
   }
+}
 
-  free(deletingNode->text);
+void SelectNodesInRect(Rectangle rect) {
+  if (nodes.count == 0)
+    return;
 
-  for (int i = index; i < nodeCount - 1; i++) {
-    nodes[i] = nodes[i + 1];
-    nodes[i].id = i;
-    visitedNodes[i] = visitedNodes[i + 1];
+  int *hits = malloc(nodes.count * sizeof(int));
+  if (!hits) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
   }
 
-  nodeCount--;
+  int hitCount = QueryNodesInRect(rect, true, hits);
+  for (int i = 0; i < hitCount; i++)
+    nodes.flags[hits[i]] |= NODE_FLAG_SELECTED;
 
-  if (nodeCount > 0) {
-    Node *newNodes = realloc(nodes, nodeCount * sizeof(Node));
-    bool *newVisited = realloc(visitedNodes, nodeCount * sizeof(bool));
-    if (!newNodes || !newVisited) {
-      printf("Yeniden tahsis hatası!\n");
-      exit(1);
-    }
-    nodes = newNodes;
-    visitedNodes = newVisited;
-  } else {
-    free(nodes);
-    free(visitedNodes);
-    nodes = NULL;
-    visitedNodes = NULL;
+  free(hits);
+}
+
+void MoveSelectedNodes(Vector2 delta) {
+  if (delta.x == 0 && delta.y == 0)
+    return;
+
+  for (int i = 0; i < nodes.count; i++) {
+    if (!(nodes.flags[i] & NODE_FLAG_SELECTED))
+      continue;
+    nodes.posX[i] += delta.x;
+    nodes.posY[i] += delta.y;
+    nodes.minX[i] += delta.x;
+    nodes.maxX[i] += delta.x;
+    nodes.minY[i] += delta.y;
+    nodes.maxY[i] += delta.y;
   }
 }
 
-void DrawGridD(int sqrSide, int bigSqr, int bigSqrCW, int bigSqrCH,
-               Color sqrColor, Color bigSqrColor) {
-  int bigW = bigSqr * bigSqrCW * sqrSide;
-  int bigH = bigSqr * bigSqrCH * sqrSide;
+/* Seçili düğümleri siler ve kalanları tek geçişte sıkıştırır; bağlantılar
+ * eski→yeni indeks tablosuyla yeniden yazılır. Silinen düğüm sayısını
+ * döndürür. */
+int DeleteSelectedNodes(void) {
+  if (nodes.count == 0)
+    return 0;
 
-  for (int x = -bigW; x <= bigW; x += sqrSide) {
-    if (x % (bigSqr * sqrSide) == 0) {
-      DrawLineEx((Vector2){x, -bigH}, (Vector2){x, bigH}, 1, bigSqrColor);
-    } else
-      DrawLine(x, -bigH, x, bigH, sqrColor);
+  int *remap = malloc(nodes.count * sizeof(int));
+  if (!remap) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
   }
 
-  for (int y = -bigH; y <= bigH; y += sqrSide) {
-    if (y % (bigSqr * sqrSide) == 0) {
-      DrawLineEx((Vector2){-bigW, y}, (Vector2){bigW, y}, 1, bigSqrColor);
-    } else
-      DrawLine(-bigW, y, bigW, y, sqrColor);
+  int kept = 0;
+  for (int i = 0; i < nodes.count; i++) {
+    if (nodes.flags[i] & NODE_FLAG_SELECTED) {
+      remap[i] = NODE_NONE;
+      FreeNodeCold(&nodes.cold[i]);
+    } else {
+      remap[i] = kept++;
+    }
   }
+
+  int deleted = nodes.count - kept;
+  if (deleted > 0) {
+    for (int i = 0; i < nodes.count; i++) {
+      int j = remap[i];
+      if (j == NODE_NONE)
+        continue;
+
+      nodes.posX[j] = nodes.posX[i];
+      nodes.posY[j] = nodes.posY[i];
+      nodes.minX[j] = nodes.minX[i];
+      nodes.minY[j] = nodes.minY[i];
+      nodes.maxX[j] = nodes.maxX[i];
+      nodes.maxY[j] = nodes.maxY[i];
+      nodes.type[j] = nodes.type[i];
+      nodes.flags[j] = nodes.flags[i];
+      nodes.cold[j] = nodes.cold[i];
+      nodes.visited[j] = nodes.visited[i];
+
+      NodeCold *cold = &nodes.cold[j];
+      if (cold->next != NODE_NONE)
+        cold->next = remap[cold->next];
+      if (cold->alt_next != NODE_NONE)
+        cold->alt_next = remap[cold->alt_next];
+    }
+    nodes.count = kept;
+    validation.rebuild = true;
+  }
+
+  free(remap);
+  return deleted;
 }
 
-void DrawNodePreview(NodeType type, Font font, Vector2 pos) {
-  Node node = CreateNode(type, pos);
-  DrawNode(&node, font);
+void FreeClipboard(NodeClipboard *clip) {
+  for (int i = 0; i < clip->count; i++)
+    free(clip->cold[i].text);
+  free(clip->type);
+  free(clip->position);
+  free(clip->cold);
+  *clip = (NodeClipboard){0};
 }
 
-void DrawNode(Node *node, Font font) {
-  float textWidth = MeasureTextEx(font, (char *)node->text, 20, 1).x;
-  float width = fmaxf(100, 20 + textWidth), height = 50 + textWidth / 10;
-  Vector2 pos = node->position;
-  Color outlineColor = node->isSelected || node->isEditing ? ORANGE : BLACK;
-  switch (node->type) {
-  case NODE_START:
-  case NODE_END: {
-    DrawRectangleRounded(
-        (Rectangle){pos.x - width / 2, pos.y - height / 2, width, height}, 1,
-        10, node->instanceColor);
-    DrawRectangleRoundedLines(
-        (Rectangle){pos.x - width / 2, pos.y - height / 2, width, height}, 1,
-        10, outlineColor);
-    break;
-  }
-  case NODE_PROCESS:
-  case NODE_VARIABLE: {
-    DrawRectangle(pos.x - width / 2, pos.y - height / 2, width, height,
-                  node->instanceColor);
-    DrawRectangleLines(pos.x - width / 2, pos.y - height / 2, width, height,
-                       outlineColor);
-    break;
-  }
-  case NODE_CALL: {
-    DrawRectangle(pos.x - width / 2, pos.y - height / 2, width, height,
-                  node->instanceColor);
-    DrawRectangleLines(pos.x - width / 2, pos.y - height / 2, width, height,
-                       outlineColor);
-    DrawRectangleLines(pos.x - width / 2 + 15, pos.y - height / 2, width - 30,
-                       height, outlineColor);
-    break;
-  }
-  case NODE_INPUT:
-  case NODE_OUTPUT: {
-    Vector2 p1 = {pos.x - width / 2, pos.y - height / 2},
-            p2 = {pos.x + width * .6f, pos.y - height / 2},
-            p3 = {pos.x + width / 2, pos.y + height / 2},
-            p4 = {pos.x - width * .6f, pos.y + height / 2};
-    DrawTriangleStrip((Vector2[]){p2, p1, p3, p4}, 4, node->instanceColor);
-    DrawLineStrip((Vector2[]){p1, p2, p3, p4, p1}, 5, outlineColor);
-    break;
+/* Seçili düğümleri panoya alır. Seçim içindeki bağlantılar panodaki yerel
+ * indekslere çevrilir, seçim dışına giden bağlantılar bırakılır. */
+void CopySelectedNodes(NodeClipboard *clip) {
+  int *local = malloc((nodes.count > 0 ? nodes.count : 1) * sizeof(int));
+  if (!local) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
   }
-  case NODE_DECISION: {
-    Vector2 p1 = {pos.x, pos.y - height / 2}, p2 = {pos.x + width / 2, pos.y},
-            p3 = {pos.x, pos.y + height / 2}, p4 = {pos.x - width / 2, pos.y};
-    DrawTriangleStrip((Vector2[]){p2, p1, p3, p4}, 4, node->instanceColor);
-    DrawLineStrip((Vector2[]){p1, p2, p3, p4, p1}, 5, outlineColor);
-    break;
+
+  int count = 0;
+  for (int i = 0; i < nodes.count; i++)
+    local[i] = nodes.flags[i] & NODE_FLAG_SELECTED ? count++ : NODE_NONE;
+
+  if (count == 0) {
+    free(local);
+    return;
   }
-  case NODE_LOOP: {
-    Vector2 p1 = {pos.x - width / 2, pos.y},
-            p2 = {pos.x - width / 4, pos.y + height / 2},
-            p3 = {pos.x + width / 4, pos.y + height / 2},
-            p4 = {pos.x + width / 2, pos.y},
-            p5 = {pos.x + width / 4, pos.y - height / 2},
-            p6 = {pos.x - width / 4, pos.y - height / 2};
 
-    DrawTriangleFan((Vector2[]){pos, p1, p2, p3, p4, p5, p6, p1}, 8,
-                    node->instanceColor);
-    DrawLineStrip((Vector2[]){p1, p2, p3, p4, p5, p6, p1}, 7, outlineColor);
-    break;
+  FreeClipboard(clip);
+  clip->type = malloc(count * sizeof(NodeType));
+  clip->position = malloc(count * sizeof(Vector2));
+  clip->cold = malloc(count * sizeof(NodeCold));
+  if (!clip->type || !clip->position || !clip->cold) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
   }
 
-  default:
-    break;
+  Vector2 min = {INFINITY, INFINITY}, max = {-INFINITY, -INFINITY};
+  for (int i = 0; i < nodes.count; i++) {
+    int j = local[i];
+    if (j == NODE_NONE)
+      continue;
+
+    NodeCold cold = nodes.cold[i];
+    cold.text = strdup(cold.text);
+    cold.ast = NULL;
+    cold.route[0] = cold.route[1] = (LinkRoute){0};
+    cold.next = cold.next != NODE_NONE ? local[cold.next] : NODE_NONE;
+    cold.alt_next =
+        cold.alt_next != NODE_NONE ? local[cold.alt_next] : NODE_NONE;
+
+    clip->type[j] = nodes.type[i];
+    clip->position[j] = GetNodePosition(i);
+    clip->cold[j] = cold;
+
+    min.x = fminf(min.x, clip->position[j].x);
+    min.y = fminf(min.y, clip->position[j].y);
+    max.x = fmaxf(max.x, clip->position[j].x);
+    max.y = fmaxf(max.y, clip->position[j].y);
   }
-  DrawTextEx(font, (char *)node->text,
-             (Vector2){pos.x - textWidth / 2, pos.y - 10}, 20, 1, WHITE);
+
+  clip->count = count;
+  clip->center = Vector2Scale(Vector2Add(min, max), 0.5f);
+  free(local);
 }
 
-void DrawLink(Node *node, Font font) {
-  Vector2 arrow;
-  if (node->next) {
-    Vector2 end = GetClosestEdge(node, node->next, font);
-    DrawArrow(node->position, end, ORANGE);
-    if (node->alt_next != NULL) {
-      DrawLabelOnLine(node->position, end, "Evet ise", font, BLACK);
-    }
-  }
-  if (node->alt_next) {
-    Vector2 end = GetClosestEdge(node, node->alt_next, font);
-    DrawArrow(node->position, end, ORANGE);
-    if (node->next != NULL) {
-      DrawLabelOnLine(node->position, end, "Hayır ise", font, BLACK);
-    }
+/* Panodaki düğümleri dizinin sonuna ekler ve yalnızca onları seçili bırakır.
+ * Eklenen ilk düğümün indeksini döndürür. */
+int PasteNodes(const NodeClipboard *clip, Vector2 offset) {
+  if (clip->count == 0)
+    return NODE_NONE;
+
+  SetAllNodesSelected(false);
+  ReserveNodes(nodes.count + clip->count);
+
+  int base = nodes.count;
+  for (int k = 0; k < clip->count; k++) {
+    int i = base + k;
+    NodeCold cold = clip->cold[k];
+    cold.text = strdup(cold.text);
+    cold.ast = NULL;
+    cold.route[0] = cold.route[1] = (LinkRoute){0};
+    cold.reachIn = 0;
+    cold.next = cold.next != NODE_NONE ? base + cold.next : NODE_NONE;
+    cold.alt_next =
+        cold.alt_next != NODE_NONE ? base + cold.alt_next : NODE_NONE;
+
+    NodeType type = clip->type[k];
+    nodes.posX[i] = clip->position[k].x + offset.x;
+    nodes.posY[i] = clip->position[k].y + offset.y;
+    nodes.type[i] = type;
+    nodes.flags[i] = NODE_FLAG_SELECTED | NODE_FLAG_EDITABLE;
+    nodes.cold[i] = cold;
+    nodes.visited[i] = false;
+    UpdateNodeBounds(i);
   }
+  nodes.count += clip->count;
+
+  /* Yapıştırılan düğümlere yalnızca yapıştırılan Başla düğümlerinden
+   * ulaşılabilir. */
+  for (int i = base; i < nodes.count; i++)
+    ValidateNodeAdded(i);
+
+  return base;
 }
 
-void DrawArrow(Vector2 start, Vector2 end, Color color) {
-  DrawLineEx(start, end, 2.0f, color);
+/* --geri alma günlüğü-- */
 
-  Vector2 dir = Vector2Normalize(Vector2Subtract(end, start));
-  float angle = atan2f(dir.y, dir.x);
-  float arrowLength = 10.0f;
-  float arrowAngle = PI / 6.0f; // 30 derece
+/* Günlük tüm diziyi kopyalamak yerine yalnızca değişikliği saklar. Düğüm
+ * indeksleri kayıtlar arasında kararlıdır: geri alma tam ters sırada
+ * uygulandığından her kayıt, kaydedildiği andaki dizi düzenini görür. */
 
-  Vector2 left = {end.x - arrowLength * cosf(angle - arrowAngle),
-                  end.y - arrowLength * sinf(angle - arrowAngle)};
+void PutBytes(ByteBuffer *buffer, const void *src, size_t size) {
+  if (buffer->size + size > buffer->capacity) {
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : 64;
+    while (capacity < buffer->size + size)
+      capacity *= 2;
+    GROW_ARRAY(buffer->data, capacity);
+    buffer->capacity = capacity;
+  }
+  memcpy(buffer->data + buffer->size, src, size);
+  buffer->size += size;
+}
 
-  Vector2 right = {end.x - arrowLength * cosf(angle + arrowAngle),
-                   end.y - arrowLength * sinf(angle + arrowAngle)};
+void GetBytes(ByteBuffer *buffer, void *dst, size_t size) {
+  memcpy(dst, buffer->data + buffer->pos, size);
+  buffer->pos += size;
+}
 
-  DrawLineEx(end, left, 2, color);
-  DrawLineEx(end, right, 2, color);
+void PutInt(ByteBuffer *buffer, int value) {
+  PutBytes(buffer, &value, sizeof(value));
 }
 
-void DrawLabelOnLine(Vector2 start, Vector2 end, const char *text, Font font,
-                     Color color) {
-  Vector2 mid = {(start.x + end.x) / 2.0f, (start.y + end.y) / 2.0f};
+int GetInt(ByteBuffer *buffer) {
+  int value;
+  GetBytes(buffer, &value, sizeof(value));
+  return value;
+}
 
-  float angle = atan2f(end.y - start.y, end.x - start.x) * RAD2DEG;
+void PutString(ByteBuffer *buffer, const char *text) {
+  int len = strlen(text);
+  PutInt(buffer, len);
+  PutBytes(buffer, text, len);
+}
 
-  Vector2 textSize = MeasureTextEx(font, text, 20, 1);
-  Vector2 origin = {textSize.x / 2.0f, textSize.y / 2.0f};
+char *GetString(ByteBuffer *buffer) {
+  int len = GetInt(buffer);
+  char *text = malloc(len + 1);
+  if (!text) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  GetBytes(buffer, text, len);
+  text[len] = '\0';
+  return text;
+}
 
-  DrawTextPro(font, text, mid, origin, angle, 20, 0, color);
+void PutNode(ByteBuffer *buffer, int index) {
+  NodeCold *cold = &nodes.cold[index];
+  unsigned char type = nodes.type[index];
+  PutBytes(buffer, &type, sizeof(type));
+  PutBytes(buffer, &nodes.posX[index], sizeof(float));
+  PutBytes(buffer, &nodes.posY[index], sizeof(float));
+  PutBytes(buffer, &cold->textWidth, sizeof(float));
+  PutBytes(buffer, &cold->instanceColor, sizeof(Color));
+  PutInt(buffer, cold->next);
+  PutInt(buffer, cold->alt_next);
+  PutString(buffer, cold->text);
 }
 
-Vector2 GetClosestEdge(Node *startNode, Node *destNode, Font font) {
-  float textWidth = MeasureTextEx(font, (char *)destNode->text, 20, 1).x;
-  float width = fmaxf(100, 20 + textWidth), height = 50 + textWidth / 10;
+void SkipNode(ByteBuffer *buffer) {
+  buffer->pos += 1 + 3 * sizeof(float) + sizeof(Color) + 2 * sizeof(int);
+  buffer->pos += GetInt(buffer);
+}
 
-  Vector2 edges[4] = {
-      {destNode->position.x + width / 2, destNode->position.y},  // sağ
-      {destNode->position.x - width / 2, destNode->position.y},  // sol
-      {destNode->position.x, destNode->position.y + height / 2}, // alt
-      {destNode->position.x, destNode->position.y - height / 2}  // üst
-  };
+/* Kaydı verilen indekse yazar; bağlantılar kaydedildiği haliyle gelir. */
+void GetNode(ByteBuffer *buffer, int index) {
+  unsigned char type;
+  GetBytes(buffer, &type, sizeof(type));
+  GetBytes(buffer, &nodes.posX[index], sizeof(float));
+  GetBytes(buffer, &nodes.posY[index], sizeof(float));
+
+  NodeCold *cold = &nodes.cold[index];
+  GetBytes(buffer, &cold->textWidth, sizeof(float));
+  GetBytes(buffer, &cold->instanceColor, sizeof(Color));
+  cold->next = GetInt(buffer);
+  cold->alt_next = GetInt(buffer);
+  cold->text = GetString(buffer);
+  cold->ast = NULL;
+  cold->reachIn = 0;
+  cold->route[0] = cold->route[1] = (LinkRoute){0};
+
+  nodes.type[index] = type;
+  nodes.flags[index] = NODE_FLAG_SELECTED | NODE_FLAG_EDITABLE;
+  nodes.visited[index] = false;
+  UpdateNodeBounds(index);
+  validation.rebuild = true;
+}
 
-  float minDist = Vector2DistanceSqr(startNode->position, edges[0]);
-  Vector2 final = edges[0];
+JournalEntry *JournalAt(int k) {
+  return &journal.entries[(journal.head + k) % JOURNAL_MAX_ENTRIES];
+}
 
-  for (int i = 1; i < 4; i++) {
-    float dist = Vector2DistanceSqr(startNode->position, edges[i]);
-    if (dist < minDist) {
-      minDist = dist;
-      final = edges[i];
+void JournalSetPayload(JournalEntry *entry, ByteBuffer *payload) {
+  journal.bytes -= entry->payload.capacity;
+  free(entry->payload.data);
+  entry->payload = payload ? *payload : (ByteBuffer){0};
+  journal.bytes += entry->payload.capacity;
+}
+
+void JournalDropOldest(void) {
+  JournalSetPayload(JournalAt(0), NULL);
+  journal.head = (journal.head + 1) % JOURNAL_MAX_ENTRIES;
+  journal.count--;
+  journal.cursor--;
+}
+
+void JournalDropNewest(void) {
+  JournalSetPayload(JournalAt(journal.count - 1), NULL);
+  journal.count--;
+}
+
+/* Bellek sınırı aşılınca önce en eski geri alma kayıtları, sonra en yeni
+ * yineleme kayıtları bırakılır; son işlem her zaman geri alınabilir. */
+void JournalTrim(void) {
+  while (journal.bytes > JOURNAL_MAX_BYTES && journal.cursor > 1)
+    JournalDropOldest();
+  while (journal.bytes > JOURNAL_MAX_BYTES && journal.count > journal.cursor)
+    JournalDropNewest();
+}
+
+void JournalPush(JournalEntry entry) {
+  while (journal.count > journal.cursor)
+    JournalDropNewest();
+  if (journal.count == JOURNAL_MAX_ENTRIES)
+    JournalDropOldest();
+
+  *JournalAt(journal.count) = entry;
+  journal.bytes += entry.payload.capacity;
+
+  journal.count++;
+  journal.cursor = journal.count;
+  JournalTrim();
+}
+
+/* Yeni düğümler dizinin sonuna eklenir; yineleme için gereken içerik ancak
+ * geri alınırken saklanır. */
+void JournalRecordAdd(int first, int count) {
+  if (count > 0)
+    JournalPush((JournalEntry){.kind = JOURNAL_ADD, .index = first,
+                               .count = count});
+}
+
+/* DeleteSelectedNodes'tan hemen önce çağrılır: silinecek düğümleri ve
+ * kalan düğümlerden onlara giden bağlantıları saklar. */
+void JournalRecordDelete(void) {
+  FinishLayoutAnimation();
+  ByteBuffer payload = {0};
+  int count = 0;
+  for (int i = 0; i < nodes.count; i++) {
+    if (!(nodes.flags[i] & NODE_FLAG_SELECTED))
+      continue;
+    PutInt(&payload, i);
+    PutNode(&payload, i);
+    count++;
+  }
+
+  if (count == 0)
+    return;
+
+  for (int i = 0; i < nodes.count; i++) {
+    if (nodes.flags[i] & NODE_FLAG_SELECTED)
+      continue;
+    NodeCold *cold = &nodes.cold[i];
+    if (cold->next != NODE_NONE &&
+        (nodes.flags[cold->next] & NODE_FLAG_SELECTED)) {
+      PutInt(&payload, i);
+      PutInt(&payload, false);
+      PutInt(&payload, cold->next);
+    }
+    if (cold->alt_next != NODE_NONE &&
+        (nodes.flags[cold->alt_next] & NODE_FLAG_SELECTED)) {
+      PutInt(&payload, i);
+      PutInt(&payload, true);
+      PutInt(&payload, cold->alt_next);
     }
   }
 
-  return final;
+  JournalPush((JournalEntry){
+      .kind = JOURNAL_DELETE, .count = count, .payload = payload});
 }
 
-char *strprintf(const char *fmt, ...) {
-  va_list args;
-  va_start(args, fmt);
+void JournalRecordMove(Vector2 delta) {
+  if (delta.x == 0 && delta.y == 0)
+    return;
 
-  // Uzunluğu öğrenmek için bir kopya argüman listesi gerekir
-  va_list args_copy;
-  va_copy(args_copy, args);
-  int len = vsnprintf(NULL, 0, fmt, args_copy);
-  va_end(args_copy);
+  ByteBuffer payload = {0};
+  int count = 0;
+  for (int i = 0; i < nodes.count; i++) {
+    if (nodes.flags[i] & NODE_FLAG_SELECTED) {
+      PutInt(&payload, i);
+      count++;
+    }
+  }
 
-  if (len < 0) {
-    va_end(args);
-    return NULL; // Hata durumu
+  JournalPush((JournalEntry){.kind = JOURNAL_MOVE,
+                             .count = count,
+                             .delta = delta,
+                             .payload = payload});
+}
+
+void JournalRecordLink(int index, bool alt, int before, int after) {
+  if (before != after)
+    JournalPush((JournalEntry){.kind = JOURNAL_LINK,
+                               .index = index,
+                               .alt = alt,
+                               .before = before,
+                               .after = after});
+}
+
+void JournalRecordText(int index, const char *before, const char *after) {
+  if (strcmp(before, after) == 0)
+    return;
+
+  ByteBuffer payload = {0};
+  PutString(&payload, before);
+  PutString(&payload, after);
+  JournalPush(
+      (JournalEntry){.kind = JOURNAL_TEXT, .index = index, .payload = payload});
+}
+
+/* Kayıttaki her düğüm eski ya da yeni yerleşim konumuna konur. */
+void PlaceNodes(ByteBuffer *payload, int count, bool after) {
+  payload->pos = 0;
+  for (int k = 0; k < count; k++) {
+    int i = GetInt(payload);
+    Vector2 before, placed;
+    GetBytes(payload, &before, sizeof(Vector2));
+    GetBytes(payload, &placed, sizeof(Vector2));
+    SetNodePosition(i, after ? placed : before);
   }
+}
 
-  char *str = malloc(len + 1); // +1 for the null terminator
-  if (!str) {
-    va_end(args);
-    return NULL; // Bellek hatası
+void MoveNodes(ByteBuffer *indices, int count, Vector2 delta) {
+  indices->pos = 0;
+  for (int k = 0; k < count; k++) {
+    int i = GetInt(indices);
+    SetNodePosition(i, (Vector2){nodes.posX[i] + delta.x,
+                                 nodes.posY[i] + delta.y});
   }
+}
 
-  vsnprintf(str, len + 1, fmt, args);
-  va_end(args);
+void SetNodeLink(int index, bool alt, int target) {
+  NodeCold *cold = &nodes.cold[index];
+  int *link = alt ? &cold->alt_next : &cold->next;
+  int before = *link;
+  *link = target;
+  if (before != target) {
+    free(cold->route[alt].points);
+    cold->route[alt] = (LinkRoute){0};
+  }
+  ValidateLinkChanged(index, before, target);
+}
 
-  return str; // Döndürülen belleği serbest bırakmayı unutma
+/* Silinen düğümleri eski indekslerine geri yerleştirir: kalan düğümler
+ * sondan başa doğru tek geçişte kaydırılır ve bağlantıları yeniden yazılır. */
+void RestoreDeletedNodes(JournalEntry *entry) {
+  ByteBuffer *payload = &entry->payload;
+  int restored = entry->count, survivors = nodes.count,
+      total = survivors + restored;
+
+  int *slots = malloc(restored * sizeof(int));
+  size_t *records = malloc(restored * sizeof(size_t));
+  int *remap = malloc((survivors > 0 ? survivors : 1) * sizeof(int));
+  if (!slots || !records || !remap) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+
+  /* Kayıtların yerini öğrenmek için yükü bir kez atlayarak oku. */
+  payload->pos = 0;
+  for (int k = 0; k < restored; k++) {
+    slots[k] = GetInt(payload);
+    records[k] = payload->pos;
+    SkipNode(payload);
+  }
+  size_t links = payload->pos;
+
+  validation.rebuild = true;
+  ReserveNodes(total);
+  SetAllNodesSelected(false);
+
+  int src = survivors - 1, k = restored - 1;
+  for (int dst = total - 1; dst >= 0; dst--) {
+    if (k >= 0 && slots[k] == dst) {
+      k--;
+      continue;
+    }
+    nodes.posX[dst] = nodes.posX[src];
+    nodes.posY[dst] = nodes.posY[src];
+    nodes.minX[dst] = nodes.minX[src];
+    nodes.minY[dst] = nodes.minY[src];
+    nodes.maxX[dst] = nodes.maxX[src];
+    nodes.maxY[dst] = nodes.maxY[src];
+    nodes.type[dst] = nodes.type[src];
+    nodes.flags[dst] = nodes.flags[src];
+    nodes.cold[dst] = nodes.cold[src];
+    nodes.visited[dst] = nodes.visited[src];
+    remap[src--] = dst;
+  }
+
+  for (int s = 0; s < survivors; s++) {
+    NodeCold *cold = &nodes.cold[remap[s]];
+    if (cold->next != NODE_NONE)
+      cold->next = remap[cold->next];
+    if (cold->alt_next != NODE_NONE)
+      cold->alt_next = remap[cold->alt_next];
+  }
+
+  for (int k = 0; k < restored; k++) {
+    payload->pos = records[k];
+    GetNode(payload, slots[k]);
+  }
+  nodes.count = total;
+
+  payload->pos = links;
+  while (payload->pos < payload->size) {
+    int source = GetInt(payload);
+    bool alt = GetInt(payload);
+    SetNodeLink(source, alt, GetInt(payload));
+  }
+
+  free(slots);
+  free(records);
+  free(remap);
 }
 
-char *append_string(char *base, const char *addition) {
-  if (!base)
-    base = "";
-  if (!addition)
-    addition = "";
+void UndoEntry(JournalEntry *entry) {
+  switch (entry->kind) {
+  case JOURNAL_ADD: {
+    ByteBuffer payload = {0};
+    for (int i = entry->index; i < nodes.count; i++) {
+      PutNode(&payload, i);
+      FreeNodeCold(&nodes.cold[i]);
+    }
+    nodes.count = entry->index;
+    validation.rebuild = true;
+    JournalSetPayload(entry, &payload);
+    break;
+  }
+  case JOURNAL_DELETE:
+    RestoreDeletedNodes(entry);
+    break;
+  case JOURNAL_MOVE:
+    MoveNodes(&entry->payload, entry->count, Vector2Negate(entry->delta));
+    break;
+  case JOURNAL_LINK:
+    SetNodeLink(entry->index, entry->alt, entry->before);
+    break;
+  case JOURNAL_TEXT:
+    entry->payload.pos = 0;
+    SetNodeText(entry->index, GetString(&entry->payload));
+    break;
+  case JOURNAL_LAYOUT:
+    PlaceNodes(&entry->payload, entry->count, false);
+    break;
+  }
+}
 
-  size_t len1 = strlen(base);
-  size_t len2 = strlen(addition);
+void RedoEntry(JournalEntry *entry) {
+  switch (entry->kind) {
+  case JOURNAL_ADD:
+    ReserveNodes(entry->index + entry->count);
+    SetAllNodesSelected(false);
+    entry->payload.pos = 0;
+    for (int i = entry->index; i < entry->index + entry->count; i++)
+      GetNode(&entry->payload, i);
+    nodes.count = entry->index + entry->count;
+    JournalSetPayload(entry, NULL);
+    break;
+  case JOURNAL_DELETE: {
+    SetAllNodesSelected(false);
+    ByteBuffer *payload = &entry->payload;
+    payload->pos = 0;
+    for (int k = 0; k < entry->count; k++) {
+      nodes.flags[GetInt(payload)] |= NODE_FLAG_SELECTED;
+      SkipNode(payload);
+    }
+    DeleteSelectedNodes();
+    break;
+  }
+  case JOURNAL_MOVE:
+    MoveNodes(&entry->payload, entry->count, entry->delta);
+    break;
+  case JOURNAL_LINK:
+    SetNodeLink(entry->index, entry->alt, entry->after);
+    break;
+  case JOURNAL_TEXT:
+    entry->payload.pos = 0;
+    free(GetString(&entry->payload));
+    SetNodeText(entry->index, GetString(&entry->payload));
+    break;
+  case JOURNAL_LAYOUT:
+    PlaceNodes(&entry->payload, entry->count, true);
+    break;
+  }
+}
 
-  char *result =
-      malloc((len1 + len2 + 1) * sizeof(char)); // +1 for the null terminator
-  if (!result)
-    return NULL;
+bool Undo(void) {
+  if (journal.cursor == 0)
+    return false;
+  FinishLayoutAnimation();
+  UndoEntry(JournalAt(--journal.cursor));
+  JournalTrim();
+  return true;
+}
 
-  strcpy(result, base);
-  strcat(result, addition);
+bool Redo(void) {
+  if (journal.cursor == journal.count)
+    return false;
+  FinishLayoutAnimation();
+  RedoEntry(JournalAt(journal.cursor++));
+  return true;
+}
 
-  return result;
+/* --isabet testi ve görüş alanı kırpma çekirdekleri-- */
+
+/* Çekirdekler sınır dizilerini blok blok tarar. SSE 4, AVX2 8 düğümü tek
+ * karşılaştırmada test eder; işlemci desteği InitNodeKernels içinde
+ * bir kez sorgulanır, desteklenmeyen platformlarda skaler sürüm kalır. */
+
+static int HitTestScalar(const NodeStore *store, int begin, int end,
+                         Vector2 point) {
+  for (int i = end - 1; i >= begin; i--) {
+    if (point.x >= store->minX[i] && point.x <= store->maxX[i] &&
+        point.y >= store->minY[i] && point.y <= store->maxY[i])
+      return i;
+  }
+  return NODE_NONE;
+}
+
+static int QueryRectScalar(const NodeStore *store, int begin, int end,
+                           Rectangle rect, bool contain, int *out) {
+  float x1 = rect.x, y1 = rect.y, x2 = rect.x + rect.width,
+        y2 = rect.y + rect.height;
+  int found = 0;
+  for (int i = begin; i < end; i++) {
+    bool hit = contain ? store->minX[i] >= x1 && store->maxX[i] <= x2 &&
+                             store->minY[i] >= y1 && store->maxY[i] <= y2
+                       : store->maxX[i] >= x1 && store->minX[i] <= x2 &&
+                             store->maxY[i] >= y1 && store->minY[i] <= y2;
+    if (hit)
+      out[found++] = i;
+  }
+  return found;
 }
 
-void addToVars(char *type, char *name) {
-  vars[var_count++] = (Variable){.name = strdup(name), .type = strdup(type)};
+static int HitTestGeneric(const NodeStore *store, Vector2 point) {
+  return HitTestScalar(store, 0, store->count, point);
+}
+
+static int QueryRectGeneric(const NodeStore *store, Rectangle rect,
+                            bool contain, int *out) {
+  return QueryRectScalar(store, 0, store->count, rect, contain, out);
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NODE_KERNELS_X86
+
+__attribute__((target("sse2"))) static int HitTestSSE(const NodeStore *store,
+                                                       Vector2 point) {
+  int blocks = store->count / 4 * 4;
+  int hit = HitTestScalar(store, blocks, store->count, point);
+  if (hit != NODE_NONE)
+    return hit;
+
+  __m128 px = _mm_set1_ps(point.x), py = _mm_set1_ps(point.y);
+  for (int i = blocks - 4; i >= 0; i -= 4) {
+    __m128 in = _mm_and_ps(
+        _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&store->minX[i]), px),
+                   _mm_cmpge_ps(_mm_loadu_ps(&store->maxX[i]), px)),
+        _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&store->minY[i]), py),
+                   _mm_cmpge_ps(_mm_loadu_ps(&store->maxY[i]), py)));
+    int mask = _mm_movemask_ps(in);
+    if (mask)
+      return i + 31 - __builtin_clz(mask);
+  }
+  return NODE_NONE;
+}
+
+__attribute__((target("sse2"))) static int
+QueryRectSSE(const NodeStore *store, Rectangle rect, bool contain, int *out) {
+  int blocks = store->count / 4 * 4, found = 0;
+  __m128 x1 = _mm_set1_ps(rect.x), y1 = _mm_set1_ps(rect.y),
+         x2 = _mm_set1_ps(rect.x + rect.width),
+         y2 = _mm_set1_ps(rect.y + rect.height);
+
+  for (int i = 0; i < blocks; i += 4) {
+    __m128 minX = _mm_loadu_ps(&store->minX[i]),
+           minY = _mm_loadu_ps(&store->minY[i]),
+           maxX = _mm_loadu_ps(&store->maxX[i]),
+           maxY = _mm_loadu_ps(&store->maxY[i]);
+    __m128 in =
+        contain ? _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(minX, x1),
+                                        _mm_cmple_ps(maxX, x2)),
+                             _mm_and_ps(_mm_cmpge_ps(minY, y1),
+                                        _mm_cmple_ps(maxY, y2)))
+                : _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(maxX, x1),
+                                        _mm_cmple_ps(minX, x2)),
+                             _mm_and_ps(_mm_cmpge_ps(maxY, y1),
+                                        _mm_cmple_ps(minY, y2)));
+    int mask = _mm_movemask_ps(in);
+    while (mask) {
+      out[found++] = i + __builtin_ctz(mask);
+      mask &= mask - 1;
+    }
+  }
+  return found + QueryRectScalar(store, blocks, store->count, rect, contain,
+                                 out + found);
 }
 
-char *CompileVar(Node *node) {
-  char type[32] = {0};
-  int i = 0, t_index = 0;
+__attribute__((target("avx2"))) static int HitTestAVX2(const NodeStore *store,
+                                                        Vector2 point) {
+  int blocks = store->count / 8 * 8;
+  int hit = HitTestScalar(store, blocks, store->count, point);
+  if (hit != NODE_NONE)
+    return hit;
+
+  __m256 px = _mm256_set1_ps(point.x), py = _mm256_set1_ps(point.y);
+  for (int i = blocks - 8; i >= 0; i -= 8) {
+    __m256 in = _mm256_and_ps(
+        _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(&store->minX[i]), px, _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(&store->maxX[i]), px, _CMP_GE_OQ)),
+        _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(&store->minY[i]), py, _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(&store->maxY[i]), py, _CMP_GE_OQ)));
+    int mask = _mm256_movemask_ps(in);
+    if (mask)
+      return i + 31 - __builtin_clz(mask);
+  }
+  return NODE_NONE;
+}
 
-  while (node->text[i] && node->text[i] != ' ') {
-    if (t_index < sizeof(type) - 1)
-      type[t_index++] = node->text[i++];
+__attribute__((target("avx2"))) static int
+QueryRectAVX2(const NodeStore *store, Rectangle rect, bool contain, int *out) {
+  int blocks = store->count / 8 * 8, found = 0;
+  __m256 x1 = _mm256_set1_ps(rect.x), y1 = _mm256_set1_ps(rect.y),
+         x2 = _mm256_set1_ps(rect.x + rect.width),
+         y2 = _mm256_set1_ps(rect.y + rect.height);
+
+  for (int i = 0; i < blocks; i += 8) {
+    __m256 minX = _mm256_loadu_ps(&store->minX[i]),
+           minY = _mm256_loadu_ps(&store->minY[i]),
+           maxX = _mm256_loadu_ps(&store->maxX[i]),
+           maxY = _mm256_loadu_ps(&store->maxY[i]);
+    __m256 in =
+        contain
+            ? _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(minX, x1, _CMP_GE_OQ),
+                                          _mm256_cmp_ps(maxX, x2, _CMP_LE_OQ)),
+                            _mm256_and_ps(_mm256_cmp_ps(minY, y1, _CMP_GE_OQ),
+                                          _mm256_cmp_ps(maxY, y2, _CMP_LE_OQ)))
+            : _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(maxX, x1, _CMP_GE_OQ),
+                                          _mm256_cmp_ps(minX, x2, _CMP_LE_OQ)),
+                            _mm256_and_ps(_mm256_cmp_ps(maxY, y1, _CMP_GE_OQ),
+                                          _mm256_cmp_ps(minY, y2, _CMP_LE_OQ)));
+    int mask = _mm256_movemask_ps(in);
+    while (mask) {
+      out[found++] = i + __builtin_ctz(mask);
+      mask &= mask - 1;
+    }
   }
-  type[t_index] = '\0';
+  return found + QueryRectScalar(store, blocks, store->count, rect, contain,
+                                 out + found);
+}
+#endif
+
+static int (*hitTestKernel)(const NodeStore *, Vector2) = HitTestGeneric;
+static int (*queryRectKernel)(const NodeStore *, Rectangle, bool,
+                              int *) = QueryRectGeneric;
+
+void InitNodeKernels(void) {
+#ifdef NODE_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    hitTestKernel = HitTestAVX2;
+    queryRectKernel = QueryRectAVX2;
+  } else if (__builtin_cpu_supports("sse2")) {
+    hitTestKernel = HitTestSSE;
+    queryRectKernel = QueryRectSSE;
+  }
+#endif
+}
 
-  while (node->text[i] == ' ')
-    i++;
+int HitTestNodes(Vector2 point) { return hitTestKernel(&nodes, point); }
 
-  char name[64] = {0};
-  int n_index = 0;
+int QueryNodesInRect(Rectangle rect, bool contain, int *out) {
+  return queryRectKernel(&nodes, rect, contain, out);
+}
 
-  for (; node->text[i]; i++) {
-    char c = node->text[i];
+void CullNodes(Rectangle view) {
+  nodes.visibleCount = QueryNodesInRect(view, false, nodes.visible);
+}
 
-    if (c == ',') {
-      name[n_index] = '\0';
-      addToVars(type, name);
-      n_index = 0;
-      memset(name, 0, sizeof(name));
-      type[t_index--] = '\0';
-    } else if (c == '*') {
-      type[t_index] = '*';
-      type[t_index++] = '\0';
-    } else if (c != ' ') {
-      if (n_index < sizeof(name) - 1)
-        name[n_index++] = c;
+/* Bağlantının iki ucu da görüş alanı dışında olabilir; bu yüzden düğüm
+ * yerine çizginin kapsayan kutusu test edilir. Yerleşimin bulduğu yol
+ * çizilecekse kutu yolun noktalarını da kapsar. */
+bool IsLinkVisible(int from, bool alt, Rectangle view) {
+  int to = alt ? nodes.cold[from].alt_next : nodes.cold[from].next;
+  float x1 = fminf(nodes.posX[from], nodes.posX[to]),
+        x2 = fmaxf(nodes.posX[from], nodes.posX[to]),
+        y1 = fminf(nodes.posY[from], nodes.posY[to]),
+        y2 = fmaxf(nodes.posY[from], nodes.posY[to]);
+  const LinkRoute *route = &nodes.cold[from].route[alt];
+  if (IsRouteValid(from, to, route)) {
+    for (int k = 0; k < route->count; k++) {
+      x1 = fminf(x1, route->points[k].x);
+      x2 = fmaxf(x2, route->points[k].x);
+      y1 = fminf(y1, route->points[k].y);
+      y2 = fmaxf(y2, route->points[k].y);
     }
   }
+  return x2 >= view.x && x1 <= view.x + view.width && y2 >= view.y &&
+         y1 <= view.y + view.height;
+}
 
-  if (n_index > 0) {
-    name[n_index] = '\0';
-    addToVars(type, name);
+/* --çalıştırma konsolu-- */
+
+/* Derlenen program ayrı bir süreçte, stdin/stdout boruları üzerinden
+ * çalışır. Borular bloklamayan kipte okunur ve her karede en fazla
+ * CONSOLE_READ_BUDGET bayt alınır; böylece çok konuşkan ya da hiç bitmeyen
+ * bir program çizim döngüsünü durduramaz. */
+
+void ConsoleAppend(const char *text, int length) {
+  for (int i = 0; i < length; i++) {
+    int end = (console.start + console.length) % CONSOLE_CAPACITY;
+    console.buffer[end] = text[i];
+    if (console.length < CONSOLE_CAPACITY)
+      console.length++;
+    else
+      console.start = (console.start + 1) % CONSOLE_CAPACITY;
   }
+}
+
+char ConsoleCharAt(int k) {
+  return console.buffer[(console.start + k) % CONSOLE_CAPACITY];
+}
+
+void ConsolePrint(const char *text) { ConsoleAppend(text, strlen(text)); }
 
-  return (char *)strprintf("\t%s;\n", node->text);
+void ConsoleClear(void) {
+  console.start = 0;
+  console.length = 0;
 }
 
-Variable *isdefined(char *name) {
-  for (int i = 0; i < var_count; i++) {
-    if (strcmp(vars[i].name, name) == 0)
-      return &vars[i];
+void ConsoleStop(void) {
+  if (console.pid > 0) {
+    kill(console.pid, SIGKILL);
+    waitpid(console.pid, NULL, 0);
+    console.pid = 0;
+    ConsolePrint("\n[Program durduruldu]\n");
   }
-  return NULL;
+  if (console.toChild >= 0)
+    close(console.toChild);
+  if (console.fromChild >= 0)
+    close(console.fromChild);
+  console.toChild = console.fromChild = -1;
+  console.pendingLength = 0;
 }
 
-bool cmpStr(char *a, char *b) { return strcmp(a, b) == 0; }
+bool ConsoleRun(const char *path) {
+  ConsoleStop();
 
-char *getScanfFormat(char *type) {
-  return cmpStr(type, "string") || cmpStr(type, "char *") ? "%s"
-         : cmpStr(type, "char")                           ? "%c"
-         : cmpStr(type, "int")                            ? "%d"
-         : cmpStr(type, "float")                          ? "%f"
-         : cmpStr(type, "double")                         ? "%lf"
-         : cmpStr(type, "long")                           ? "%ld"
-                                                          : "";
-}
-
-char *CompileInput(Node *node) {
-  char *nodeText = node->text;
-  char prompt[256] = {0};
-  char varname[64] = {0};
-
-  const char *quote_start = strchr(nodeText, '\"');
-  const char *quote_end = strrchr(nodeText, '\"');
-  if (!quote_start || !quote_end || quote_start == quote_end)
-    return NULL;
+  int input[2], output[2];
+  if (pipe(input) == -1) {
+    ConsolePrint("[Boru oluşturulamadı]\n");
+    return false;
+  }
+  if (pipe(output) == -1) {
+    close(input[0]);
+    close(input[1]);
+    ConsolePrint("[Boru oluşturulamadı]\n");
+    return false;
+  }
 
-  int prompt_len = quote_end - quote_start - 1;
-  strncpy(prompt, quote_start + 1, prompt_len);
-  prompt[prompt_len] = '\0';
+  pid_t pid = fork();
+  if (pid == -1) {
+    close(input[0]);
+    close(input[1]);
+    close(output[0]);
+    close(output[1]);
+    ConsolePrint("[Süreç başlatılamadı]\n");
+    return false;
+  }
 
-  const char *comma = strchr(quote_end, ',');
-  if (!comma)
-    return NULL;
+  if (pid == 0) {
+    dup2(input[0], STDIN_FILENO);
+    dup2(output[1], STDOUT_FILENO);
+    dup2(output[1], STDERR_FILENO);
+    close(input[0]);
+    close(input[1]);
+    close(output[0]);
+    close(output[1]);
+    execl(path, path, (char *)NULL);
+    _exit(127);
+  }
 
-  while (*comma == ',' || *comma == ' ')
-    comma++;
-  strncpy(varname, comma, sizeof(varname) - 1);
-  varname[sizeof(varname) - 1] = '\0';
+  close(input[0]);
+  close(output[1]);
+  fcntl(input[1], F_SETFL, fcntl(input[1], F_GETFL) | O_NONBLOCK);
+  fcntl(output[0], F_SETFL, fcntl(output[0], F_GETFL) | O_NONBLOCK);
+
+  console.pid = pid;
+  console.toChild = input[1];
+  console.fromChild = output[0];
+  console.visible = true;
+  console.focused = true;
+  return true;
+}
 
-  Variable *var = isdefined(varname);
-  if (!var) {
-    fputs("Değer tanımlanmamış!", stdout);
-    return "<DORANODEHATA>";
+/* Bekleyen girdiyi boru kabul ettiği kadar yazar; kalanı sonraki karelere
+ * bırakır. */
+void ConsoleFlushInput(void) {
+  int written = 0;
+  while (console.toChild >= 0 && written < console.pendingLength) {
+    ssize_t sent = write(console.toChild, console.pending + written,
+                         console.pendingLength - written);
+    if (sent > 0) {
+      written += sent;
+    } else if (sent == -1 && errno == EINTR) {
+      continue;
+    } else {
+      if (sent == -1 && errno != EAGAIN) {
+        ConsolePrint("[Girdi iletilemedi]\n");
+        written = console.pendingLength;
+      }
+      break;
+    }
   }
-  char *type = var->type;
+  memmove(console.pending, console.pending + written,
+          console.pendingLength - written);
+  console.pendingLength -= written;
+}
 
-  if (strcmp(type, "char*") == 0 || strcmp(type, "string") == 0) {
-    return strprintf("printf(\"%s\");\nfgets(%s, sizeof(%s), "
-                     "stdin);\n%s[strcspn(%s, \"\\n\")] = 0;\n",
-                     prompt, varname, varname, varname, varname);
-  } else {
-    char *format = getScanfFormat(type);
-    return strprintf("printf(\"%s\");\nscanf(\"%s\", &%s);\n", prompt, format,
-                     varname);
+/* Her karede bir kez çağrılır; hiçbir zaman beklemez. */
+void ConsolePoll(void) {
+  if (console.pendingLength > 0)
+    ConsoleFlushInput();
+
+  if (console.fromChild >= 0) {
+    char chunk[4096];
+    int budget = CONSOLE_READ_BUDGET;
+    while (budget > 0) {
+      ssize_t got = read(console.fromChild, chunk,
+                         budget < (int)sizeof(chunk) ? budget : sizeof(chunk));
+      if (got > 0) {
+        ConsoleAppend(chunk, got);
+        budget -= got;
+      } else if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+        close(console.fromChild);
+        console.fromChild = -1;
+        break;
+      } else {
+        break;
+      }
+    }
+  }
+
+  if (console.pid > 0 && console.fromChild < 0) {
+    int status;
+    if (waitpid(console.pid, &status, WNOHANG) == console.pid) {
+      console.pid = 0;
+      char message[64];
+      snprintf(message, sizeof(message), "\n[Program bitti, çıkış kodu: %d]\n",
+               WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+      ConsolePrint(message);
+      if (console.toChild >= 0) {
+        close(console.toChild);
+        console.toChild = -1;
+      }
+      console.pendingLength = 0;
+    }
   }
 }
 
-char *CompileLoop(Node *node) {
-  char *text;
-  int semicolonCount = 0;
-  for (int i = 0; node->text[i] != '\0'; i++) {
-    if (node->text[i] == ';')
-      semicolonCount++;
+/* Yazılan satırı programın stdin'ine iletir ve konsola yansıtır. */
+void ConsoleSubmitInput(void) {
+  console.input[console.inputLength++] = '\n';
+  ConsoleAppend(console.input, console.inputLength);
+  if (console.toChild >= 0) {
+    GROW_ARRAY(console.pending, console.pendingLength + console.inputLength);
+    memcpy(console.pending + console.pendingLength, console.input,
+           console.inputLength);
+    console.pendingLength += console.inputLength;
+    ConsoleFlushInput();
   }
+  console.inputLength = 0;
+}
 
-  if (semicolonCount == 0) {
-    text = (char *)strprintf("\twhile (%s) {\n", node->text);
-  } else {
-    text = (char *)strprintf("\tfor (%s) {\n", node->text);
+void ConsoleHandleKeys(void) {
+  int key = GetCharPressed();
+  while (key > 0) {
+    int utf8Size = 0;
+    const char *utf8 = CodepointToUTF8(key, &utf8Size);
+    if (key >= 32 &&
+        console.inputLength + utf8Size < (int)sizeof(console.input) - 1) {
+      memcpy(console.input + console.inputLength, utf8, utf8Size);
+      console.inputLength += utf8Size;
+    }
+    key = GetCharPressed();
   }
 
-  text = CompileCode(node->next, text);
-  text = append_string(text, "\t}\n");
-  text = CompileCode(node->alt_next, text);
+  if (IsKeyPressed(KEY_BACKSPACE) && console.inputLength > 0) {
+    console.input[console.inputLength] = '\0';
+    BackspaceUTF8(console.input);
+    console.inputLength = strlen(console.input);
+  }
 
-  return (char *)text;
+  if (IsKeyPressed(KEY_ENTER))
+    ConsoleSubmitInput();
 }
 
-char *CompileCode(Node *node, char *textBefore) {
-  if (node == NULL)
-    return "<DORANODEHATA>";
+Rectangle GetConsoleRect(void) {
+  return (Rectangle){MENU_WIDTH, GetScreenHeight() - CONSOLE_HEIGHT,
+                     GetScreenWidth() - MENU_WIDTH - 63, CONSOLE_HEIGHT};
+}
 
-  char *text = textBefore;
+void DrawConsole(SdfFont *font) {
+  if (!console.visible)
+    return;
 
-  if (node->type == NODE_START) {
-    text = append_string(text, "int main(void) {\n");
+  Rectangle rect = GetConsoleRect();
+  float lineHeight = 18, fontSize = 16;
+  DrawRectangleRec(rect, (Color){30, 30, 30, 235});
+  DrawRectangleLinesEx(rect, 1, console.focused ? ORANGE : BLACK);
+
+  const char *status = console.pid > 0 ? "Konsol - çalışıyor" : "Konsol";
+  DrawTextSDF(font, status, (Vector2){rect.x + 6, rect.y + 4}, fontSize, 1,
+              LIGHTGRAY);
+
+  /* Halka tamponun sonundan geriye doğru yalnızca görünen satırlar bulunur. */
+  int maxLines = fminf(64, (rect.height - 2 * lineHeight - 8) / lineHeight);
+  int lineStart[64], lineEnd[64], lineCount = 0;
+  int end = console.length;
+  if (end > 0 && ConsoleCharAt(end - 1) == '\n')
+    end--; // son satır sonu boş bir satır açmasın
+  for (int k = end - 1; console.length > 0 && lineCount < maxLines; k--) {
+    if (k < 0 || ConsoleCharAt(k) == '\n') {
+      lineStart[lineCount] = k + 1;
+      lineEnd[lineCount] = end;
+      lineCount++;
+      end = k;
+      if (k < 0)
+        break;
+    }
   }
 
-  if (visitedNodes[node->id] == true && node->type == NODE_LOOP) {
-    text = append_string(text, "\tcontinue;\n");
-    return text;
-  } else if (visitedNodes[node->id] == true) {
-    text = append_string(text,
-                         (char *)strprintf("\tgoto doraNode_%i;\n", node->id));
-    return text;
+  SetTextClipSDF(font, &rect);
+  for (int n = 0; n < lineCount; n++) {
+    int line = lineCount - 1 - n;
+    char text[256];
+    int length = 0;
+    for (int k = lineStart[line]; k < lineEnd[line] && length < 255; k++)
+      text[length++] = ConsoleCharAt(k);
+    text[length] = '\0';
+    DrawTextSDF(font, text,
+                (Vector2){rect.x + 6, rect.y + 4 + lineHeight * (n + 1)},
+                fontSize, 1, WHITE);
   }
 
-  visitedNodes[node->id] = true;
+  console.input[console.inputLength] = '\0';
+  DrawTextSDF(font, TextFormat("> %s", console.input),
+              (Vector2){rect.x + 6, rect.y + rect.height - lineHeight - 4},
+              fontSize, 1, console.focused ? ORANGE : GRAY);
+  SetTextClipSDF(font, NULL);
+}
 
-  if (node->type != NODE_START)
-    text = append_string(text, (char *)strprintf("doraNode_%i:\n", node->id));
-  switch (node->type) {
-  case NODE_START:
-    text = CompileCode(node->next, text);
-    break;
-  case NODE_END:
-    text = append_string(text, "\treturn 0;\n}\n");
-    break;
-  case NODE_INPUT:
-    text = append_string(text, CompileInput(node));
-    text = CompileCode(node->next, text);
-    break;
-  case NODE_OUTPUT:
-    text =
-        append_string(text, (char *)strprintf("\tprintf(%s);\n", node->text));
-    text = CompileCode(node->next, text);
-    break;
-  case NODE_VARIABLE:
-    text = append_string(text, CompileVar(node));
-    text = CompileCode(node->next, text);
-    break;
-  case NODE_DECISION:
-    text = append_string(
-        text, (char *)strprintf(
-                  "\tif (%s) goto doraNode_%i;\n\telse goto doraNode_%i;\n",
-                  node->text, node->next->id, node->alt_next->id));
-    text = CompileCode(node->next, text);
-    text = CompileCode(node->alt_next, text);
-    break;
-  case NODE_LOOP:
-    text = append_string(text, CompileLoop(node));
-    break;
-  default:
-    text = append_string(text, (char *)strprintf("\t%s;\n", node->text));
-    text = CompileCode(node->next, text);
-    break;
-  }
+/* --iş parçacığı havuzu-- */
 
-  return text;
+void *ThreadPoolWorker(void *arg) {
+  ThreadPool *pool = arg;
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (pool->head == pool->tail && !pool->stopping)
+      pthread_cond_wait(&pool->wake, &pool->lock);
+    if (pool->head == pool->tail && pool->stopping)
+      break;
+
+    PoolTask task = pool->tasks[pool->head % pool->capacity];
+    pool->head++;
+    pthread_mutex_unlock(&pool->lock);
+
+    task.func(task.arg);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0)
+      pthread_cond_broadcast(&pool->idle);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
 }
 
-char *CompileCodeToEXE(Node *node, char *fileName) {
-  memset(visitedNodes, 0, nodeCount * sizeof(bool));
-  char *code = (char *)CompileCode(
-      node, "#include <stdio.h>\n#include <stdbool.h>\n#include "
-            "<math.h>\n#include <string.h>\n\ntypedef char* string;\n\n");
+void ThreadPoolInit(ThreadPool *pool, int threadCount) {
+  *pool = (ThreadPool){0};
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  pthread_cond_init(&pool->idle, NULL);
 
-  printf("%s\n", code);
+  pool->threads = malloc(threadCount * sizeof(pthread_t));
+  if (!pool->threads) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  for (int i = 0; i < threadCount; i++) {
+    if (pthread_create(&pool->threads[i], NULL, ThreadPoolWorker, pool) != 0)
+      break;
+    pool->threadCount++;
+  }
+}
 
-  TCCState *s = tcc_new();
-  if (!s) {
-    fprintf(stderr, "Failed to create TCC state\n");
-    return NULL;
+void ThreadPoolSubmit(ThreadPool *pool, void (*func)(void *), void *arg) {
+  /* İş parçacığı açılamadıysa iş çağıranın üzerinde çalışır. */
+  if (pool->threadCount == 0) {
+    func(arg);
+    return;
   }
 
-  tcc_add_include_path(s, "/usr/include");
-  tcc_add_include_path(s, "/usr/include/x86_64-linux-gnu");
-  tcc_add_include_path(s, "/usr/lib/gcc/x86_64-linux-gnu/13/include");
+  pthread_mutex_lock(&pool->lock);
+  if (pool->tail - pool->head == pool->capacity) {
+    int capacity = pool->capacity > 0 ? pool->capacity * 2 : 16;
+    PoolTask *tasks = malloc(capacity * sizeof(PoolTask));
+    if (!tasks) {
+      printf("Bellek tahsisi başarısız!\n");
+      exit(1);
+    }
+    for (int i = pool->head; i < pool->tail; i++)
+      tasks[i - pool->head] = pool->tasks[i % pool->capacity];
+    free(pool->tasks);
+    pool->tasks = tasks;
+    pool->tail -= pool->head;
+    pool->head = 0;
+    pool->capacity = capacity;
+  }
+  pool->tasks[pool->tail % pool->capacity] = (PoolTask){func, arg};
+  pool->tail++;
+  pool->pending++;
+  pthread_cond_signal(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+}
 
-  tcc_set_output_type(s, TCC_OUTPUT_EXE);
+/* Kuyruktaki ve çalışan tüm işler bitene kadar bekler. */
+void ThreadPoolWait(ThreadPool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  while (pool->pending > 0)
+    pthread_cond_wait(&pool->idle, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
 
-  tcc_add_library(s, "m");
+void ThreadPoolShutdown(ThreadPool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
 
-  if (tcc_compile_string(s, code) == -1) {
-    fprintf(stderr, "TCC compile error\n");
-    tcc_delete(s);
-    return NULL;
+  for (int i = 0; i < pool->threadCount; i++)
+    pthread_join(pool->threads[i], NULL);
+
+  free(pool->threads);
+  free(pool->tasks);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->wake);
+  pthread_cond_destroy(&pool->idle);
+}
+
+void DrawGridD(int sqrSide, int bigSqr, int bigSqrCW, int bigSqrCH,
+               Color sqrColor, Color bigSqrColor) {
+  int bigW = bigSqr * bigSqrCW * sqrSide;
+  int bigH = bigSqr * bigSqrCH * sqrSide;
+
+  for (int x = -bigW; x <= bigW; x += sqrSide) {
+    if (x % (bigSqr * sqrSide) == 0) {
+      DrawLineEx((Vector2){x, -bigH}, (Vector2){x, bigH}, 1, bigSqrColor);
+    } else
+      DrawLine(x, -bigH, x, bigH, sqrColor);
   }
 
-  if (tcc_output_file(s, fileName) == -1) {
-    fprintf(stderr, "TCC output error\n");
-    tcc_delete(s);
-    return NULL;
+  for (int y = -bigH; y <= bigH; y += sqrSide) {
+    if (y % (bigSqr * sqrSide) == 0) {
+      DrawLineEx((Vector2){-bigW, y}, (Vector2){bigW, y}, 1, bigSqrColor);
+    } else
+      DrawLine(-bigW, y, bigW, y, sqrColor);
   }
+}
+
+void DrawNodePreview(NodeType type, SdfFont *font, Vector2 pos) {
+  const char *text = NODE_TYPE_NAME[type];
+  DrawNodeShape(type, pos, text, MeasureTextSDF(font, text, 20, 1).x,
+                NODE_TYPE_COLOR[type], BLACK, font);
+}
+
+void DrawNode(int index, SdfFont *font) {
+  unsigned char flags = nodes.flags[index];
+  const char *error = flags & NODE_FLAG_EDITING ? NULL : GetNodeIssue(index);
+  Color outlineColor =
+      flags & (NODE_FLAG_SELECTED | NODE_FLAG_EDITING) ? ORANGE
+      : error                                          ? RED
+                                                       : BLACK;
+  /* Hiçbir Başla düğümünden ulaşılamayan düğümler soluk çizilir. */
+  Color fill = nodes.cold[index].instanceColor;
+  if (!(flags & NODE_FLAG_REACHABLE))
+    fill = Fade(fill, 0.4f);
+  DrawNodeShape(nodes.type[index], GetNodePosition(index),
+                nodes.cold[index].text, nodes.cold[index].textWidth, fill,
+                outlineColor, font);
+  if (error)
+    DrawTextSDF(font, error,
+                (Vector2){nodes.minX[index], nodes.maxY[index] + 4}, 16, 1,
+                RED);
+}
+
+void DrawNodeShape(NodeType type, Vector2 pos, const char *text,
+                   float textWidth, Color fill, Color outlineColor,
+                   SdfFont *font) {
+  float width = fmaxf(100, 20 + textWidth), height = 50 + textWidth / 10;
+  switch (type) {
+  case NODE_START:
+  case NODE_END: {
+    DrawRectangleRounded(
+        (Rectangle){pos.x - width / 2, pos.y - height / 2, width, height}, 1,
+        10, fill);
+    DrawRectangleRoundedLines(
+        (Rectangle){pos.x - width / 2, pos.y - height / 2, width, height}, 1,
+        10, outlineColor);
+    break;
+  }
+  case NODE_PROCESS:
+  case NODE_VARIABLE: {
+    DrawRectangle(pos.x - width / 2, pos.y - height / 2, width, height, fill);
+    DrawRectangleLines(pos.x - width / 2, pos.y - height / 2, width, height,
+                       outlineColor);
+    break;
+  }
+  case NODE_CALL: {
+    DrawRectangle(pos.x - width / 2, pos.y - height / 2, width, height, fill);
+    DrawRectangleLines(pos.x - width / 2, pos.y - height / 2, width, height,
+                       outlineColor);
+    DrawRectangleLines(pos.x - width / 2 + 15, pos.y - height / 2, width - 30,
+                       height, outlineColor);
+    break;
+  }
+  case NODE_INPUT:
+  case NODE_OUTPUT: {
+    Vector2 p1 = {pos.x - width / 2, pos.y - height / 2},
+            p2 = {pos.x + width * .6f, pos.y - height / 2},
+            p3 = {pos.x + width / 2, pos.y + height / 2},
+            p4 = {pos.x - width * .6f, pos.y + height / 2};
+    DrawTriangleStrip((Vector2[]){p2, p1, p3, p4}, 4, fill);
+    DrawLineStrip((Vector2[]){p1, p2, p3, p4, p1}, 5, outlineColor);
+    break;
+  }
+  case NODE_DECISION: {
+    Vector2 p1 = {pos.x, pos.y - height / 2}, p2 = {pos.x + width / 2, pos.y},
+            p3 = {pos.x, pos.y + height / 2}, p4 = {pos.x - width / 2, pos.y};
+    DrawTriangleStrip((Vector2[]){p2, p1, p3, p4}, 4, fill);
+    DrawLineStrip((Vector2[]){p1, p2, p3, p4, p1}, 5, outlineColor);
+    break;
+  }
+  case NODE_LOOP: {
+    Vector2 p1 = {pos.x - width / 2, pos.y},
+            p2 = {pos.x - width / 4, pos.y + height / 2},
+            p3 = {pos.x + width / 4, pos.y + height / 2},
+            p4 = {pos.x + width / 2, pos.y},
+            p5 = {pos.x + width / 4, pos.y - height / 2},
+            p6 = {pos.x - width / 4, pos.y - height / 2};
+
+    DrawTriangleFan((Vector2[]){pos, p1, p2, p3, p4, p5, p6, p1}, 8, fill);
+    DrawLineStrip((Vector2[]){p1, p2, p3, p4, p5, p6, p1}, 7, outlineColor);
+    break;
+  }
+
+  default:
+    break;
+  }
+  DrawTextSDF(font, text, (Vector2){pos.x - textWidth / 2, pos.y - 10}, 20, 1,
+              WHITE);
+}
+
+void DrawLink(int index, SdfFont *font) {
+  NodeCold *cold = &nodes.cold[index];
+  Vector2 start = GetNodePosition(index), labelEnd;
+  if (cold->next != NODE_NONE) {
+    labelEnd = DrawLinkPath(index, false, cold->next);
+    if (cold->alt_next != NODE_NONE) {
+      DrawLabelOnLine(start, labelEnd, "Evet ise", font, BLACK);
+    }
+  }
+  if (cold->alt_next != NODE_NONE) {
+    labelEnd = DrawLinkPath(index, true, cold->alt_next);
+    if (cold->next != NODE_NONE) {
+      DrawLabelOnLine(start, labelEnd, "Hayır ise", font, BLACK);
+    }
+  }
+}
+
+/* Yerleşimin bulduğu yol hâlâ geçerliyse bağlantı kırık çizgi olarak, değilse
+ * düz çizilir. Etiketin yazılacağı ilk parçanın sonunu döndürür. */
+Vector2 DrawLinkPath(int index, bool alt, int target) {
+  const LinkRoute *route = &nodes.cold[index].route[alt];
+  Vector2 start = GetNodePosition(index);
+  if (!IsRouteValid(index, target, route)) {
+    Vector2 end = GetClosestEdge(start, target);
+    DrawArrow(start, end, ORANGE);
+    return end;
+  }
+
+  for (int p = 1; p < route->count - 1; p++)
+    DrawLineEx(route->points[p - 1], route->points[p], 2.0f, ORANGE);
+  start = route->points[route->count - 2];
+  DrawArrow(start, GetClosestEdge(start, target), ORANGE);
+  return route->points[1];
+}
+
+void DrawArrow(Vector2 start, Vector2 end, Color color) {
+  DrawLineEx(start, end, 2.0f, color);
+
+  Vector2 dir = Vector2Normalize(Vector2Subtract(end, start));
+  float angle = atan2f(dir.y, dir.x);
+  float arrowLength = 10.0f;
+  float arrowAngle = PI / 6.0f; // 30 derece
+
+  Vector2 left = {end.x - arrowLength * cosf(angle - arrowAngle),
+                  end.y - arrowLength * sinf(angle - arrowAngle)};
+
+  Vector2 right = {end.x - arrowLength * cosf(angle + arrowAngle),
+                   end.y - arrowLength * sinf(angle + arrowAngle)};
+
+  DrawLineEx(end, left, 2, color);
+  DrawLineEx(end, right, 2, color);
+}
+
+void DrawLabelOnLine(Vector2 start, Vector2 end, const char *text,
+                     SdfFont *font, Color color) {
+  Vector2 mid = {(start.x + end.x) / 2.0f, (start.y + end.y) / 2.0f};
+
+  float angle = atan2f(end.y - start.y, end.x - start.x) * RAD2DEG;
+
+  Vector2 textSize = MeasureTextSDF(font, text, 20, 1);
+  Vector2 origin = {textSize.x / 2.0f, textSize.y / 2.0f};
+
+  DrawTextProSDF(font, text, mid, origin, angle, 20, 0, color);
+}
+
+Vector2 GetClosestEdge(Vector2 start, int destIndex) {
+  Vector2 dest = GetNodePosition(destIndex);
+
+  Vector2 edges[4] = {
+      {nodes.maxX[destIndex], dest.y}, // sağ
+      {nodes.minX[destIndex], dest.y}, // sol
+      {dest.x, nodes.maxY[destIndex]}, // alt
+      {dest.x, nodes.minY[destIndex]}  // üst
+  };
+
+  float minDist = Vector2DistanceSqr(start, edges[0]);
+  Vector2 final = edges[0];
+
+  for (int i = 1; i < 4; i++) {
+    float dist = Vector2DistanceSqr(start, edges[i]);
+    if (dist < minDist) {
+      minDist = dist;
+      final = edges[i];
+    }
+  }
+
+  return final;
+}
+
+char *strprintf(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+
+  // Uzunluğu öğrenmek için bir kopya argüman listesi gerekir
+  va_list args_copy;
+  va_copy(args_copy, args);
+  int len = vsnprintf(NULL, 0, fmt, args_copy);
+  va_end(args_copy);
+
+  if (len < 0) {
+    va_end(args);
+    return NULL; // Hata durumu
+  }
+
+  char *str = malloc(len + 1); // +1 for the null terminator
+  if (!str) {
+    va_end(args);
+    return NULL; // Bellek hatası
+  }
+
+  vsnprintf(str, len + 1, fmt, args);
+  va_end(args);
+
+  return str; // Döndürülen belleği serbest bırakmayı unutma
+}
+
+char *append_string(char *base, const char *addition) {
+  if (!base)
+    base = "";
+  if (!addition)
+    addition = "";
+
+  size_t len1 = strlen(base);
+  size_t len2 = strlen(addition);
+
+  char *result =
+      malloc((len1 + len2 + 1) * sizeof(char)); // +1 for the null terminator
+  if (!result)
+    return NULL;
+
+  strcpy(result, base);
+  strcat(result, addition);
+
+  return result;
+}
+
+void addToVars(CodegenContext *ctx, char *type, char *name) {
+  if (ctx->var_count >= MAX_VARIABLES)
+    return;
+  ctx->vars[ctx->var_count++] =
+      (Variable){.name = strdup(name), .type = strdup(type)};
+}
+
+/* Değer düğümündeki bildirim olduğu gibi yazılır; değişkenler tür
+ * denetiminde kullanılmak üzere tabloya eklenir. */
+char *CompileVar(CodegenContext *ctx, int index) {
+  const Declaration *decl = &nodes.cold[index].ast->decl;
+  CheckDeclaration(ctx, index, decl, false);
+
+  char *code = DeclarationToC(decl);
+  char *text = strprintf("\t%s;\n", code);
+  free(code);
+  return text;
+}
+
+Variable *isdefined(CodegenContext *ctx, char *name) {
+  for (int i = 0; i < ctx->var_count; i++) {
+    if (strcmp(ctx->vars[i].name, name) == 0)
+      return &ctx->vars[i];
+  }
+  return NULL;
+}
+
+bool cmpStr(char *a, char *b) { return strcmp(a, b) == 0; }
+
+bool IsStringType(char *type) {
+  return cmpStr(type, "string") || cmpStr(type, "char*") ||
+         cmpStr(type, "char[]");
+}
+
+char *getScanfFormat(char *type) {
+  return IsStringType(type)    ? "%s"
+         : cmpStr(type, "char")   ? " %c"
+         : cmpStr(type, "int")    ? "%d"
+         : cmpStr(type, "float")  ? "%f"
+         : cmpStr(type, "double") ? "%lf"
+         : cmpStr(type, "long")   ? "%ld"
+                                  : "";
+}
+
+char *CompileInput(CodegenContext *ctx, int index) {
+  NodeAst *ast = nodes.cold[index].ast;
+  const char *prompt = ast->args[0]->text;
+  char *varname = (char *)ast->args[1]->text;
+
+  Variable *var = isdefined(ctx, varname);
+  if (!var) {
+    ReportNodeError(ctx, index, "'%s' tanımlanmamış", varname);
+    return NULL;
+  }
+  char *type = var->type;
+
+  if (IsStringType(type)) {
+    return strprintf("\tfputs(%s, stdout);\n\tfgets(%s, sizeof(%s), "
+                     "stdin);\n\t%s[strcspn(%s, \"\\n\")] = 0;\n",
+                     prompt, varname, varname, varname, varname);
+  }
+
+  char *format = getScanfFormat(type);
+  if (format[0] == '\0') {
+    ReportNodeError(ctx, index, "'%s' türünde değer okunamaz", type);
+    return NULL;
+  }
+  return strprintf("\tfputs(%s, stdout);\n\tscanf(\"%s\", &%s);\n", prompt,
+                   format, varname);
+}
+
+char *CompileOutput(CodegenContext *ctx, int index) {
+  NodeAst *ast = nodes.cold[index].ast;
+  CheckFormatArgs(ctx, index, ast->args, ast->argCount);
+
+  char *text = strdup("\tprintf(");
+  for (int i = 0; i < ast->argCount; i++) {
+    char *arg = ExprToC(ast->args[i]);
+    text = append_string(text, i > 0 ? ", " : "");
+    text = append_string(text, arg);
+    free(arg);
+  }
+  return append_string(text, ");\n");
+}
+
+char *CompileStatement(CodegenContext *ctx, int index, const Expr *e) {
+  CheckExpr(ctx, index, e);
+  char *code = ExprToC(e);
+  char *text = strprintf("\t%s;\n", code);
+  free(code);
+  return text;
+}
+
+char *CompileLoop(CodegenContext *ctx, int index) {
+  NodeCold *node = &nodes.cold[index];
+  NodeAst *ast = node->ast;
+  char *text;
+
+  if (ast->isFor) {
+    char *init = NULL, *cond = NULL, *step = NULL;
+    if (ast->decl.type) {
+      CheckDeclaration(ctx, index, &ast->decl, true);
+      init = DeclarationToC(&ast->decl);
+    } else if (ast->init) {
+      CheckExpr(ctx, index, ast->init);
+      init = ExprToC(ast->init);
+    }
+    if (ast->expr) {
+      CheckExpr(ctx, index, ast->expr);
+      cond = ExprToC(ast->expr);
+    }
+    if (ast->step) {
+      CheckExpr(ctx, index, ast->step);
+      step = ExprToC(ast->step);
+    }
+
+    text = strprintf("\tfor (%s;%s%s;%s%s) {\n", init ? init : "",
+                     cond ? " " : "", cond ? cond : "", step ? " " : "",
+                     step ? step : "");
+    free(init);
+    free(cond);
+    free(step);
+  } else {
+    CheckExpr(ctx, index, ast->expr);
+    char *cond = ExprToC(ast->expr);
+    text = strprintf("\twhile (%s) {\n", cond);
+    free(cond);
+  }
+
+  text = CompileCode(ctx, node->next, text);
+  text = append_string(text, "\t}\n");
+  text = CompileCode(ctx, node->alt_next, text);
+
+  return (char *)text;
+}
+
+/* Çağır düğümüne yalnızca bir ad yazılmışsa argümansız çağrıya çevrilir. */
+char *CompileCall(CodegenContext *ctx, int index) {
+  Expr *e = nodes.cold[index].ast->expr;
+  Expr call = {.kind = EXPR_CALL, .left = e};
+  if (e->kind == EXPR_IDENT && !isdefined(ctx, (char *)e->text))
+    return CompileStatement(ctx, index, &call);
+  return CompileStatement(ctx, index, e);
+}
+
+char *CompileReturn(CodegenContext *ctx, int index) {
+  const Expr *value = nodes.cold[index].ast->expr;
+  char *returnType = ctx->function->returnType;
+
+  if (strcmp(returnType, "void") == 0) {
+    if (value)
+      ReportNodeError(ctx, index, "%s değer döndürmez", ctx->function->name);
+    return strdup("\treturn;\n");
+  }
+  if (!value)
+    return strdup("\treturn 0;\n");
+
+  CheckAssignable(ctx, index, ValueTypeFromName(returnType),
+                  CheckExpr(ctx, index, value));
+  char *code = ExprToC(value);
+  char *text = strprintf("\treturn %s;\n", code);
+  free(code);
+  return text;
+}
+
+/* Karar düğümü tek bir koşullu atlamaya çevrilir: "Evet" kolu hemen
+ * arkasından gelir. Koşul sabitse yalnızca seçilen kol üretilir. */
+char *CompileDecision(CodegenContext *ctx, int index, char *text) {
+  NodeCold *node = &nodes.cold[index];
+  const Expr *cond = node->ast->expr;
+  CheckExpr(ctx, index, cond);
+
+  if (cond->kind == EXPR_INT || cond->kind == EXPR_FLOAT) {
+    bool taken = cond->kind == EXPR_INT ? cond->intValue != 0
+                                        : cond->floatValue != 0;
+    return CompileCode(ctx, taken ? node->next : node->alt_next, text);
+  }
+
+  char *code = ConditionToC(cond, true);
+  text = append_string(
+      text, strprintf("\tif (%s) goto doraNode_%i;\n", code, node->alt_next));
+  free(code);
+  text = CompileCode(ctx, node->next, text);
+  text = CompileCode(ctx, node->alt_next, text);
+  return text;
+}
+
+char *CompileCode(CodegenContext *ctx, int index, char *textBefore) {
+  if (index == NODE_NONE)
+    return textBefore; // eksik bağlantı düğümün kendisinde bildirilir
+
+  NodeType type = nodes.type[index];
+  NodeCold *node = &nodes.cold[index];
+  NodeAst *ast = node->ast;
+  char *text = textBefore;
+
+  if (type == NODE_START) {
+    text = append_string(text, strprintf("%s {\n", ctx->function->signature));
+    /* Konsol bir boru olduğundan çıktı tamponlanmadan gönderilir. */
+    if (ctx->function->isMain)
+      text = append_string(text, "\tsetvbuf(stdout, NULL, _IONBF, 0);\n");
+  }
+
+  if (ctx->visited[index] == true && type == NODE_LOOP) {
+    text = append_string(text, "\tcontinue;\n");
+    return text;
+  } else if (ctx->visited[index] == true) {
+    text = append_string(text,
+                         (char *)strprintf("\tgoto doraNode_%i;\n", index));
+    return text;
+  }
+
+  ctx->visited[index] = true;
+
+  if (type != NODE_START && ctx->labeled[index])
+    text = append_string(text, (char *)strprintf("doraNode_%i:;\n", index));
+
+  /* Hatalı düğümün kodu üretilmez ama sonraki düğümler de denetlensin diye
+   * akış izlenmeye devam eder. */
+  const char *problem = NULL;
+  if (type != NODE_START && ast->error[0])
+    problem = ast->error;
+  else if (type != NODE_START && type != NODE_END &&
+           strcmp(node->text, NODE_TYPE_NAME[type]) == 0)
+    problem = "Düğüm metni girilmemiş";
+  if (GetLinkIssue(index))
+    ReportNodeError(ctx, index, "%s", GetLinkIssue(index));
+  if (problem) {
+    ReportNodeError(ctx, index, "%s", problem);
+    if (node->next != NODE_NONE)
+      text = CompileCode(ctx, node->next, text);
+    if (node->alt_next != NODE_NONE)
+      text = CompileCode(ctx, node->alt_next, text);
+    return text;
+  }
+
+  switch (type) {
+  case NODE_START:
+    text = CompileCode(ctx, node->next, text);
+    break;
+  case NODE_END:
+    text = append_string(text, CompileReturn(ctx, index));
+    break;
+  case NODE_INPUT:
+    text = append_string(text, CompileInput(ctx, index));
+    text = CompileCode(ctx, node->next, text);
+    break;
+  case NODE_OUTPUT:
+    text = append_string(text, CompileOutput(ctx, index));
+    text = CompileCode(ctx, node->next, text);
+    break;
+  case NODE_VARIABLE:
+    text = append_string(text, CompileVar(ctx, index));
+    text = CompileCode(ctx, node->next, text);
+    break;
+  case NODE_CALL:
+    text = append_string(text, CompileCall(ctx, index));
+    text = CompileCode(ctx, node->next, text);
+    break;
+  case NODE_DECISION:
+    text = CompileDecision(ctx, index, text);
+    break;
+  case NODE_LOOP:
+    text = append_string(text, CompileLoop(ctx, index));
+    break;
+  default:
+    for (int i = 0; i < ast->argCount; i++)
+      text = append_string(text, CompileStatement(ctx, index, ast->args[i]));
+    text = CompileCode(ctx, node->next, text);
+    break;
+  }
+
+  return text;
+}
+
+void ReportTCCError(void *opaque, const char *message) {
+  ConsolePrint(message);
+  ConsolePrint("\n");
+}
+
+/* --alt akışlar ve paralel derleme-- */
+
+bool IsIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+/* Başla düğümünün metni fonksiyonun imzasıdır: "kare", "int kare" ya da
+ * "int kare(int x)" yazılabilir. Varsayılan metin ve "main" ana programdır. */
+bool ParseFunctionSignature(const char *text, FunctionInfo *fn) {
+  *fn = (FunctionInfo){0};
+
+  while (*text == ' ')
+    text++;
+  int length = strlen(text);
+  while (length > 0 && text[length - 1] == ' ')
+    length--;
+
+  const char *mainName = NODE_TYPE_NAME[NODE_START];
+  if (length == 0 ||
+      (length == strlen(mainName) && strncmp(text, mainName, length) == 0) ||
+      (length == 4 && strncmp(text, "main", length) == 0)) {
+    fn->name = strdup("main");
+    fn->returnType = strdup("int");
+    fn->params = strdup("void");
+    fn->isMain = true;
+  } else {
+    const char *paren = memchr(text, '(', length);
+    int headLength = paren ? paren - text : length;
+    while (headLength > 0 && text[headLength - 1] == ' ')
+      headLength--;
+
+    int nameStart = headLength;
+    while (nameStart > 0 && IsIdentifierChar(text[nameStart - 1]))
+      nameStart--;
+    if (nameStart == headLength || (text[nameStart] >= '0' &&
+                                    text[nameStart] <= '9'))
+      return false;
+
+    int typeLength = nameStart;
+    while (typeLength > 0 && text[typeLength - 1] == ' ')
+      typeLength--;
+
+    fn->name = strndup(text + nameStart, headLength - nameStart);
+    fn->returnType =
+        typeLength > 0 ? strndup(text, typeLength) : strdup("void");
+
+    if (paren) {
+      const char *close = memchr(paren, ')', text + length - paren);
+      if (!close)
+        return false;
+      fn->params = strndup(paren + 1, close - paren - 1);
+    }
+    if (!fn->params || strspn(fn->params, " ") == strlen(fn->params)) {
+      free(fn->params);
+      fn->params = strdup("void");
+    }
+    fn->isMain = strcmp(fn->name, "main") == 0;
+  }
+
+  fn->signature = strprintf("%s %s(%s)", fn->returnType, fn->name, fn->params);
+  return true;
+}
+
+/* Parametreler fonksiyon içinde tanımlı değişken sayılır. */
+void AddParamsToVars(CodegenContext *ctx, const char *params) {
+  /* Havuzdaki işlerden aynı anda çağrılır; strtok'un ortak durumu
+   * kullanılmaz. */
+  char *copy = strdup(params), *rest = NULL;
+  for (char *param = strtok_r(copy, ",", &rest); param;
+       param = strtok_r(NULL, ",", &rest)) {
+    int end = strlen(param);
+    while (end > 0 && param[end - 1] == ' ')
+      end--;
+    int nameStart = end;
+    while (nameStart > 0 && IsIdentifierChar(param[nameStart - 1]))
+      nameStart--;
+    if (nameStart == end || nameStart == 0)
+      continue;
+
+    char *name = strndup(param + nameStart, end - nameStart);
+    param[nameStart] = '\0';
+    char *type = param + strspn(param, " ");
+    int typeEnd = strlen(type);
+    while (typeEnd > 0 && type[typeEnd - 1] == ' ')
+      type[--typeEnd] = '\0';
+    addToVars(ctx, type, name);
+    free(name);
+  }
+  free(copy);
+}
+
+void FreeFunctionInfo(FunctionInfo *fn) {
+  free(fn->name);
+  free(fn->returnType);
+  free(fn->params);
+  free(fn->signature);
+}
+
+unsigned long long HashStringFrom(unsigned long long hash, const char *text) {
+  for (; *text; text++) {
+    hash ^= (unsigned char)*text;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+unsigned long long HashString(const char *text) {
+  return HashStringFrom(14695981039346656037ULL, text); // FNV-1a
+}
+
+bool ContainsIdentifier(const char *text, const char *name) {
+  int length = strlen(name);
+  for (const char *at = strstr(text, name); at; at = strstr(at + 1, name)) {
+    if ((at == text || !IsIdentifierChar(at[-1])) &&
+        !IsIdentifierChar(at[length]))
+      return true;
+  }
+  return false;
+}
+
+/* Önbellek özeti fonksiyonun gövdesinden ve yalnızca gövdenin çağırdığı
+ * fonksiyonların bildirimlerinden oluşur; başka bir alt şemanın eklenmesi ya
+ * da silinmesi bu fonksiyonu yeniden derletmez. */
+unsigned long long HashFunctionSource(const CompileJob *job) {
+  const char *body = job->source + strlen(job->prelude);
+  unsigned long long hash = HashString(body);
+  for (int k = 0; k < job->functionCount; k++) {
+    const FunctionInfo *fn = &job->functions[k];
+    if (fn != job->function && ContainsIdentifier(body, fn->name))
+      hash = HashStringFrom(hash, fn->signature);
+  }
+  return hash;
+}
+
+void CollectTCCError(void *opaque, const char *message) {
+  CompileJob *job = opaque;
+  job->errors = append_string(job->errors, message);
+  job->errors = append_string(job->errors, "\n");
+}
+
+/* Havuzdaki bir iş parçacığında çalışır: fonksiyonun kodunu üretip denetler ve
+ * kaynak değişmediyse önceki nesne dosyasını kullanır, değiştiyse derler. Düğüm
+ * deposu yalnızca okunur; her işin kendi ziyaret ve değişken tablosu vardır. */
+void CompileFunctionJob(void *arg) {
+  CompileJob *job = arg;
+  CodegenContext *ctx = calloc(1, sizeof(CodegenContext));
+  bool *visited = calloc(nodes.count > 0 ? nodes.count : 1, sizeof(bool));
+  if (!ctx || !visited) {
+    job->failed = true;
+    free(ctx);
+    free(visited);
+    return;
+  }
+
+  ctx->visited = visited;
+  ctx->function = job->function;
+  ctx->functions = job->functions;
+  ctx->functionCount = job->functionCount;
+  ctx->labeled = job->labeled;
+  AddParamsToVars(ctx, job->function->params);
+
+  char *code = CompileCode(ctx, job->function->start, (char *)job->prelude);
+  job->source = append_string(code, "}\n");
+  job->hash = HashFunctionSource(job);
+  job->diagnostics = ctx->errors;
+  job->diagnosticCount = ctx->errorCount;
+
+  for (int i = 0; i < ctx->var_count; i++) {
+    free(ctx->vars[i].name);
+    free(ctx->vars[i].type);
+  }
+  free(ctx);
+  free(visited);
+
+  /* Düğüm hataları zaten bildirildi; derleyicinin anlaşılmaz iletilerine
+   * gerek yok. */
+  if (job->diagnosticCount > 0) {
+    job->failed = true;
+    return;
+  }
+
+  if (job->cachedHash == job->hash && access(job->objectPath, R_OK) == 0) {
+    job->reused = true;
+    return;
+  }
+
+  /* libtcc iş parçacığı güvenli değildir; durumlar ayrı olsa da derleme
+   * çağrıları sıraya alınır. Bu yüzden yalnızca kod üretimi paralel çalışır;
+   * soğuk derlemede kazanç önbellekten gelir, havuzdan değil. */
+  pthread_mutex_lock(&tccLock);
+  TCCState *s = tcc_new();
+  if (!s) {
+    job->failed = true;
+  } else {
+    tcc_set_error_func(s, job, CollectTCCError);
+    tcc_add_include_path(s, "/usr/include");
+    tcc_add_include_path(s, "/usr/include/x86_64-linux-gnu");
+    tcc_add_include_path(s, "/usr/lib/gcc/x86_64-linux-gnu/13/include");
+    tcc_set_output_type(s, TCC_OUTPUT_OBJ);
+
+    job->failed = tcc_compile_string(s, job->source) == -1 ||
+                  tcc_output_file(s, job->objectPath) == -1;
+    tcc_delete(s);
+  }
+  pthread_mutex_unlock(&tccLock);
+}
+
+CompiledFunction *FindCompiledFunction(const char *name) {
+  for (int i = 0; i < compiledCount; i++) {
+    if (strcmp(compiledFunctions[i].name, name) == 0)
+      return &compiledFunctions[i];
+  }
+  return NULL;
+}
+
+void RememberCompiledFunction(const char *name, unsigned long long hash) {
+  CompiledFunction *entry = FindCompiledFunction(name);
+  if (!entry) {
+    GROW_ARRAY(compiledFunctions, compiledCount + 1);
+    entry = &compiledFunctions[compiledCount++];
+    entry->name = strdup(name);
+  }
+  entry->hash = hash;
+}
+
+/* Her Başla düğümü ayrı bir C fonksiyonu ve ayrı bir çeviri birimidir.
+ * Birimler iş parçacığı havuzunda üretilip nesne dosyalarına derlenir, sonra
+ * tek bir çalıştırılabilir dosyada bağlanır. */
+bool CompileCodeToEXE(char *fileName) {
+  int functionCount = 0;
+  for (int i = 0; i < nodes.count; i++)
+    functionCount += nodes.type[i] == NODE_START;
+
+  if (functionCount == 0) {
+    ConsolePrint("[Başla düğümü yok]\n");
+    return false;
+  }
+
+  FunctionInfo *functions = calloc(functionCount, sizeof(FunctionInfo));
+  CompileJob *jobs = calloc(functionCount, sizeof(CompileJob));
+  if (!functions || !jobs) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+
+  bool ok = true;
+  int mainCount = 0;
+  for (int i = 0, k = 0; i < nodes.count; i++) {
+    if (nodes.type[i] != NODE_START)
+      continue;
+
+    if (!ParseFunctionSignature(nodes.cold[i].text, &functions[k])) {
+      ConsolePrint(TextFormat("[Geçersiz fonksiyon imzası: %s]\n",
+                              nodes.cold[i].text));
+      ok = false;
+    }
+    functions[k].start = i;
+    mainCount += functions[k].isMain;
+    for (int j = 0; ok && j < k; j++) {
+      if (strcmp(functions[j].name, functions[k].name) == 0) {
+        ConsolePrint(
+            TextFormat("[%s iki kez tanımlanmış]\n", functions[k].name));
+        ok = false;
+      }
+    }
+    k++;
+  }
+
+  if (ok && mainCount != 1) {
+    ConsolePrint("[Tam olarak bir ana Başla düğümü olmalı]\n");
+    ok = false;
+  }
+
+  /* İşler düğüm ağaçlarını yalnızca okur; ayrıştırma burada yapılır. Koşullu
+   * atlamanın "Hayır" hedefi ve birden fazla yerden gelinen düğümler etiket
+   * alır. */
+  bool *labeled = calloc(nodes.count > 0 ? nodes.count : 1, sizeof(bool));
+  int *incoming = calloc(nodes.count > 0 ? nodes.count : 1, sizeof(int));
+  if (!labeled || !incoming) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  for (int i = 0; i < nodes.count; i++) {
+    GetNodeAst(i)->compileError[0] = '\0';
+    NodeCold *cold = &nodes.cold[i];
+    if (cold->next != NODE_NONE)
+      incoming[cold->next]++;
+    if (cold->alt_next != NODE_NONE) {
+      incoming[cold->alt_next]++;
+      labeled[cold->alt_next] |= nodes.type[i] == NODE_DECISION;
+    }
+  }
+  for (int i = 0; i < nodes.count; i++)
+    labeled[i] |= incoming[i] > 1;
+  free(incoming);
+
+  char *prelude = NULL;
+  if (ok) {
+    prelude = append_string(
+        NULL, "#include <stdio.h>\n#include <stdlib.h>\n#include "
+              "<stdbool.h>\n#include <math.h>\n#include "
+              "<string.h>\n\ntypedef char* string;\n\n");
+    for (int k = 0; k < functionCount; k++)
+      prelude = append_string(prelude,
+                              strprintf("%s;\n", functions[k].signature));
+    prelude = append_string(prelude, "\n");
+
+    for (int k = 0; k < functionCount; k++) {
+      CompiledFunction *cached = FindCompiledFunction(functions[k].name);
+      jobs[k] = (CompileJob){.function = &functions[k],
+                             .functions = functions,
+                             .functionCount = functionCount,
+                             .labeled = labeled,
+                             .prelude = prelude,
+                             .cachedHash = cached ? cached->hash : 0};
+      snprintf(jobs[k].objectPath, sizeof(jobs[k].objectPath), "%s_%s.o",
+               fileName, functions[k].name);
+      ThreadPoolSubmit(&threadPool, CompileFunctionJob, &jobs[k]);
+    }
+    ThreadPoolWait(&threadPool);
+  }
+
+  int reused = 0;
+  for (int k = 0; prelude && k < functionCount; k++) {
+    CompileJob *job = &jobs[k];
+    for (int d = 0; d < job->diagnosticCount; d++) {
+      NodeError *error = &job->diagnostics[d];
+      NodeAst *ast = GetNodeAst(error->index);
+      if (!ast->compileError[0])
+        snprintf(ast->compileError, sizeof(ast->compileError), "%s",
+                 error->message);
+      ConsolePrint(TextFormat("[%s] %s: %s\n", job->function->name,
+                              nodes.cold[error->index].text, error->message));
+    }
+    if (job->diagnosticCount == 0) {
+      ConsolePrint(job->source);
+      ConsolePrint("\n");
+    }
+    if (job->errors)
+      ConsolePrint(job->errors);
+    if (job->failed) {
+      ConsolePrint(TextFormat("[%s derlenemedi]\n", job->function->name));
+      ok = false;
+    } else {
+      RememberCompiledFunction(job->function->name, job->hash);
+      reused += job->reused;
+    }
+  }
+
+  if (ok) {
+    TCCState *s = tcc_new();
+    if (!s) {
+      fprintf(stderr, "Failed to create TCC state\n");
+      ok = false;
+    } else {
+      tcc_set_error_func(s, NULL, ReportTCCError);
+      tcc_set_output_type(s, TCC_OUTPUT_EXE);
+      for (int k = 0; k < functionCount; k++)
+        tcc_add_file(s, jobs[k].objectPath);
+      tcc_add_library(s, "m");
+
+      if (tcc_output_file(s, fileName) == -1) {
+        fprintf(stderr, "TCC output error\n");
+        ConsolePrint("[Çıktı dosyası yazılamadı]\n");
+        ok = false;
+      }
+      tcc_delete(s);
+    }
+  }
+
+  if (ok)
+    ConsolePrint(TextFormat("[%d fonksiyon, %d yeniden kullanıldı]\n",
+                            functionCount, reused));
+
+  for (int k = 0; k < functionCount; k++) {
+    for (int d = 0; d < jobs[k].diagnosticCount; d++)
+      free(jobs[k].diagnostics[d].message);
+    free(jobs[k].diagnostics);
+    free(jobs[k].source);
+    free(jobs[k].errors);
+    FreeFunctionInfo(&functions[k]);
+  }
+  free(jobs);
+  free(functions);
+  free(labeled);
+  free(prelude);
+  return ok;
+}
+/* --ifade ayrıştırıcı-- */
+
+void *AstAlloc(NodeAst *ast, size_t size) {
+  size = (size + 7) & ~(size_t)7;
+  AstBlock *block = ast->arena;
+  if (!block || block->used + size > block->size) {
+    size_t capacity = size > 2048 ? size : 2048;
+    block = malloc(sizeof(AstBlock) + capacity);
+    if (!block) {
+      printf("Bellek tahsisi başarısız!\n");
+      exit(1);
+    }
+    block->next = ast->arena;
+    block->used = 0;
+    block->size = capacity;
+    ast->arena = block;
+  }
+  void *memory = block->data + block->used;
+  block->used += size;
+  memset(memory, 0, size);
+  return memory;
+}
+
+char *AstStrndup(NodeAst *ast, const char *text, int length) {
+  char *copy = AstAlloc(ast, length + 1);
+  memcpy(copy, text, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+void FreeNodeAst(NodeAst *ast) {
+  if (!ast)
+    return;
+  while (ast->arena) {
+    AstBlock *next = ast->arena->next;
+    free(ast->arena);
+    ast->arena = next;
+  }
+  free(ast);
+}
+
+typedef enum {
+  TOKEN_END,
+  TOKEN_NUMBER,
+  TOKEN_STRING,
+  TOKEN_CHAR,
+  TOKEN_IDENT,
+  TOKEN_OP,
+} TokenKind;
+
+typedef struct {
+  TokenKind kind;
+  const char *start;
+  int length;
+  const char *op; // TOKEN_OP için işleç tablosundaki karşılığı
+} Token;
+
+typedef struct {
+  NodeAst *ast;
+  const char *pos;
+  Token token;
+} Parser;
+
+/* Uzun işleçler önce denenir. */
+const char *OPERATORS[] = {
+    "<<=", ">>=", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=",
+    "&&",  "||",  "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "+",
+    "-",   "*",   "/",  "%",  "<",  ">",  "=",  "!",  "~",  "&",  "|",
+    "^",   "?",   ":",  "(",  ")",  "[",  "]",  "{",  "}",  ",",  ";",
+    "."};
+
+const char *TYPE_WORDS[] = {"int",    "float",  "double",   "char",
+                            "long",   "short",  "unsigned", "signed",
+                            "bool",   "string", "const",    "void"};
+
+bool ParseFailed(Parser *p) { return p->ast->error[0] != '\0'; }
+
+void ParseError(Parser *p, const char *message) {
+  if (!ParseFailed(p))
+    snprintf(p->ast->error, sizeof(p->ast->error), "%s", message);
+}
+
+void NextToken(Parser *p) {
+  const char *c = p->pos;
+  while (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r')
+    c++;
+
+  Token token = {.kind = TOKEN_END, .start = c};
+  if (*c == '\0') {
+  } else if ((*c >= '0' && *c <= '9') ||
+             (*c == '.' && c[1] >= '0' && c[1] <= '9')) {
+    token.kind = TOKEN_NUMBER;
+    while (IsIdentifierChar(*c) || *c == '.' ||
+           ((*c == '+' || *c == '-') && (c[-1] == 'e' || c[-1] == 'E') &&
+            !(token.start[0] == '0' &&
+              (token.start[1] == 'x' || token.start[1] == 'X'))))
+      c++;
+  } else if (*c == '"' || *c == '\'') {
+    char quote = *c++;
+    token.kind = quote == '"' ? TOKEN_STRING : TOKEN_CHAR;
+    while (*c && *c != quote) {
+      if (*c == '\\' && c[1])
+        c++;
+      c++;
+    }
+    if (*c != quote) {
+      ParseError(p, quote == '"' ? "Kapanmamış metin" : "Kapanmamış karakter");
+      token.kind = TOKEN_END;
+    } else {
+      c++;
+    }
+  } else if (IsIdentifierChar(*c) || (unsigned char)*c >= 0x80) {
+    token.kind = TOKEN_IDENT;
+    while (IsIdentifierChar(*c) || (unsigned char)*c >= 0x80)
+      c++;
+  } else {
+    for (int i = 0; i < sizeof(OPERATORS) / sizeof(OPERATORS[0]); i++) {
+      int length = strlen(OPERATORS[i]);
+      if (strncmp(c, OPERATORS[i], length) == 0) {
+        token.kind = TOKEN_OP;
+        token.op = OPERATORS[i];
+        c += length;
+        break;
+      }
+    }
+    if (token.kind != TOKEN_OP) {
+      ParseError(p, TextFormat("Beklenmeyen karakter '%c'", *c));
+      c++;
+    }
+  }
+
+  token.length = c - token.start;
+  p->pos = c;
+  p->token = token;
+}
+
+bool IsOp(Parser *p, const char *op) {
+  return p->token.kind == TOKEN_OP && strcmp(p->token.op, op) == 0;
+}
+
+bool AcceptOp(Parser *p, const char *op) {
+  if (!IsOp(p, op))
+    return false;
+  NextToken(p);
+  return true;
+}
+
+void ExpectOp(Parser *p, const char *op) {
+  if (!AcceptOp(p, op))
+    ParseError(p, TextFormat("'%s' bekleniyordu", op));
+}
+
+bool IsTypeWord(const Token *token) {
+  if (token->kind != TOKEN_IDENT)
+    return false;
+  for (int i = 0; i < sizeof(TYPE_WORDS) / sizeof(TYPE_WORDS[0]); i++) {
+    if (strlen(TYPE_WORDS[i]) == token->length &&
+        strncmp(TYPE_WORDS[i], token->start, token->length) == 0)
+      return true;
+  }
+  return false;
+}
+
+Expr *NewExpr(Parser *p, ExprKind kind) {
+  Expr *e = AstAlloc(p->ast, sizeof(Expr));
+  e->kind = kind;
+  return e;
+}
+
+bool IsNumber(const Expr *e) {
+  return e->kind == EXPR_INT || e->kind == EXPR_FLOAT;
+}
+
+double NumberValue(const Expr *e) {
+  return e->kind == EXPR_INT ? (double)e->intValue : e->floatValue;
+}
+
+/* Yan etkisi olmayan ifadeler sadeleştirmede düşürülebilir. */
+bool IsPure(const Expr *e) {
+  if (!e)
+    return true;
+  switch (e->kind) {
+  case EXPR_ASSIGN:
+  case EXPR_CALL:
+  case EXPR_POSTFIX:
+    return false;
+  case EXPR_UNARY:
+    if (strcmp(e->op, "++") == 0 || strcmp(e->op, "--") == 0)
+      return false;
+    return IsPure(e->left);
+  default:
+    return IsPure(e->left) && IsPure(e->right) && IsPure(e->third);
+  }
+}
+
+Expr *MakeInt(Parser *p, long long value) {
+  Expr *e = NewExpr(p, EXPR_INT);
+  e->intValue = value;
+  return e;
+}
+
+Expr *MakeFloat(Parser *p, double value) {
+  Expr *e = NewExpr(p, EXPR_FLOAT);
+  e->floatValue = value;
+  return e;
+}
+
+/* Üretilen C'de int türünde olan sabit: son eki yok ve int'e sığıyor. */
+bool IsIntConstant(const Expr *e) {
+  if (e->kind != EXPR_INT || e->intValue < INT_MIN || e->intValue > INT_MAX)
+    return false;
+  if (!e->text)
+    return true;
+  const char *digits = e->text[0] == '-' ? e->text + 1 : e->text;
+  return !strpbrk(digits, "uUlL") && strtoull(digits, NULL, 0) <= INT_MAX;
+}
+
+/* Son eki olmayan ondalık sabit; C'de double'dır. "0.1f" float olduğundan
+ * double ile hesaplanıp yazılırsa değeri ve türü değişir. */
+bool IsDoubleConstant(const Expr *e) {
+  return e->kind == EXPR_FLOAT && (!e->text || !strpbrk(e->text, "fFlL"));
+}
+
+Expr *FoldUnary(Parser *p, Expr *e) {
+  Expr *x = e->left;
+  if (x->kind == EXPR_UNARY && strcmp(e->op, "-") == 0 &&
+      strcmp(x->op, "-") == 0)
+    return x->left;
+  if (!IsNumber(x))
+    return e;
+
+  if (strcmp(e->op, "-") == 0) {
+    Expr *negated = x->kind == EXPR_INT ? MakeInt(p, -x->intValue)
+                                        : MakeFloat(p, -x->floatValue);
+    if (x->text && x->text[0] == '-') {
+      negated->text = x->text + 1;
+    } else if (x->text) { // "-1.5f", "-0x10" yazıldığı gibi kalsın
+      char *text = AstAlloc(p->ast, strlen(x->text) + 2);
+      text[0] = '-';
+      strcpy(text + 1, x->text);
+      negated->text = text;
+    }
+    return negated;
+  }
+  if (strcmp(e->op, "+") == 0)
+    return x;
+  if (!IsIntConstant(x) && !IsDoubleConstant(x))
+    return e;
+  if (strcmp(e->op, "!") == 0)
+    return MakeInt(p, NumberValue(x) == 0);
+  if (strcmp(e->op, "~") == 0 && x->kind == EXPR_INT)
+    return MakeInt(p, ~x->intValue);
+  return e;
+}
+
+/* Program int ile hesaplar; int'e sığmayan sonuç katlanmaz, taşma davranışı
+ * çalışma anına bırakılır. INT_MIN de dışarıda kalır: "-2147483648" C'de
+ * long türündedir. */
+Expr *FoldedInt(Parser *p, Expr *e, long long value) {
+  return value > INT_MIN && value <= INT_MAX ? MakeInt(p, value) : e;
+}
+
+/* İki sabit işlenen hesaplanır; sabit olmayanlarda etkisiz elemanlar
+ * (x + 0, x * 1, ...) atılır. */
+Expr *FoldBinary(Parser *p, Expr *e) {
+  Expr *a = e->left, *b = e->right;
+  const char *op = e->op;
+
+  if (IsNumber(a) && IsNumber(b)) {
+    bool isFloat = a->kind == EXPR_FLOAT || b->kind == EXPR_FLOAT;
+    long long x = a->intValue, y = b->intValue;
+    double fx = NumberValue(a), fy = NumberValue(b);
+
+    if ((strcmp(op, "/") == 0 || strcmp(op, "%") == 0) && !isFloat &&
+        y == 0) {
+      ParseError(p, "Sıfıra bölme");
+      return e;
+    }
+
+    /* 1 / 0.0 geçerli C'dir (sonsuz) ve sabit olarak yazılamaz. */
+    if (!(IsIntConstant(a) || IsDoubleConstant(a)) ||
+        !(IsIntConstant(b) || IsDoubleConstant(b)) ||
+        (isFloat && strcmp(op, "/") == 0 && fy == 0))
+      return e;
+
+    if (strcmp(op, "+") == 0)
+      return isFloat ? MakeFloat(p, fx + fy) : FoldedInt(p, e, x + y);
+    if (strcmp(op, "-") == 0)
+      return isFloat ? MakeFloat(p, fx - fy) : FoldedInt(p, e, x - y);
+    if (strcmp(op, "*") == 0)
+      return isFloat ? MakeFloat(p, fx * fy) : FoldedInt(p, e, x * y);
+    if (strcmp(op, "/") == 0)
+      return isFloat ? MakeFloat(p, fx / fy) : FoldedInt(p, e, x / y);
+    if (strcmp(op, "<") == 0)
+      return MakeInt(p, fx < fy);
+    if (strcmp(op, "<=") == 0)
+      return MakeInt(p, fx <= fy);
+    if (strcmp(op, ">") == 0)
+      return MakeInt(p, fx > fy);
+    if (strcmp(op, ">=") == 0)
+      return MakeInt(p, fx >= fy);
+    if (strcmp(op, "==") == 0)
+      return MakeInt(p, fx == fy);
+    if (strcmp(op, "!=") == 0)
+      return MakeInt(p, fx != fy);
+    if (strcmp(op, "&&") == 0)
+      return MakeInt(p, fx != 0 && fy != 0);
+    if (strcmp(op, "||") == 0)
+      return MakeInt(p, fx != 0 || fy != 0);
+
+    if (isFloat) {
+      if (strchr("%&|^", op[0]) || strcmp(op, "<<") == 0 ||
+          strcmp(op, ">>") == 0)
+        ParseError(p, TextFormat("'%s' ondalık sayıya uygulanamaz", op));
+      return e;
+    }
+    if (strcmp(op, "%") == 0)
+      return FoldedInt(p, e, x % y);
+    if (strcmp(op, "&") == 0)
+      return MakeInt(p, x & y);
+    if (strcmp(op, "|") == 0)
+      return MakeInt(p, x | y);
+    if (strcmp(op, "^") == 0)
+      return MakeInt(p, x ^ y);
+    if (strcmp(op, "<<") == 0 && x >= 0 && y >= 0 && y < 32)
+      return FoldedInt(p, e, x << y);
+    if (strcmp(op, ">>") == 0 && y >= 0 && y < 32)
+      return MakeInt(p, x >> y);
+    return e;
+  }
+
+  /* "0 && x" ve "1 || x" sağ tarafı hiç çalıştırmaz. */
+  if (IsNumber(a) && strcmp(op, "&&") == 0 && NumberValue(a) == 0)
+    return MakeInt(p, 0);
+  if (IsNumber(a) && strcmp(op, "||") == 0 && NumberValue(a) != 0)
+    return MakeInt(p, 1);
+
+  bool aZero = IsNumber(a) && NumberValue(a) == 0,
+       bZero = IsNumber(b) && NumberValue(b) == 0,
+       aOne = IsNumber(a) && NumberValue(a) == 1,
+       bOne = IsNumber(b) && NumberValue(b) == 1;
+
+  /* Tamsayı sıfırla toplama türü değiştirmez; ondalık sabitte dönüşüm
+   * anlamı olabileceği için dokunulmaz. */
+  if (strcmp(op, "+") == 0 && bZero && IsIntConstant(b))
+    return a;
+  if (strcmp(op, "+") == 0 && aZero && IsIntConstant(a))
+    return b;
+  if (strcmp(op, "-") == 0 && bZero && IsIntConstant(b))
+    return a;
+  if ((strcmp(op, "*") == 0 || strcmp(op, "/") == 0) && bOne &&
+      IsIntConstant(b))
+    return a;
+  if (strcmp(op, "*") == 0 && aOne && IsIntConstant(a))
+    return b;
+  /* "x * 0" katlanmaz: x ondalıksa sonuç int değil double olmalıdır. */
+  if ((strcmp(op, "/") == 0 || strcmp(op, "%") == 0) && bZero &&
+      b->kind == EXPR_INT) {
+    ParseError(p, "Sıfıra bölme");
+    return e;
+  }
+  return e;
+}
+
+int BinaryPrecedence(const char *op) {
+  /* PREC_OR'dan PREC_MULTIPLICATIVE'e kadar sırayla. */
+  const char *levels[][4] = {{"||"},       {"&&"},
+                             {"|"},        {"^"},
+                             {"&"},        {"==", "!="},
+                             {"<", "<=", ">", ">="},
+                             {"<<", ">>"}, {"+", "-"},
+                             {"*", "/", "%"}};
+  for (int level = 0; level < 10; level++) {
+    for (int i = 0; i < 4 && levels[level][i]; i++) {
+      if (strcmp(op, levels[level][i]) == 0)
+        return PREC_OR + level;
+    }
+  }
+  return 0;
+}
+
+bool IsAssignOp(const char *op) {
+  int length = strlen(op);
+  return op[length - 1] == '=' && strcmp(op, "==") != 0 &&
+         strcmp(op, "!=") != 0 && strcmp(op, "<=") != 0 &&
+         strcmp(op, ">=") != 0;
+}
+
+bool IsLvalue(const Expr *e) {
+  return e->kind == EXPR_IDENT || e->kind == EXPR_INDEX ||
+         e->kind == EXPR_MEMBER ||
+         (e->kind == EXPR_UNARY && strcmp(e->op, "*") == 0);
+}
+
+Expr *ParseExpression(Parser *p);
+Expr *ParseUnary(Parser *p);
+
+Expr *ParsePrimary(Parser *p) {
+  Token token = p->token;
+  switch (token.kind) {
+  case TOKEN_NUMBER: {
+    NextToken(p);
+    char *text = AstStrndup(p->ast, token.start, token.length);
+    char *end;
+    Expr *e;
+    if (strpbrk(text, ".eE") && !(text[0] == '0' && (text[1] == 'x' ||
+                                                     text[1] == 'X'))) {
+      e = NewExpr(p, EXPR_FLOAT);
+      e->floatValue = strtod(text, &end);
+      if (*end == 'f' || *end == 'F')
+        end++;
+    } else {
+      e = NewExpr(p, EXPR_INT);
+      e->intValue = strtoll(text, &end, 0);
+      while (*end == 'u' || *end == 'U' || *end == 'l' || *end == 'L')
+        end++;
+    }
+    if (*end != '\0')
+      ParseError(p, TextFormat("Geçersiz sayı '%s'", text));
+    e->text = text;
+    return e;
+  }
+  case TOKEN_STRING: {
+    /* Yan yana metinler ayrı yazılır; birleştirmeyi derleyici yapar. İçerik
+     * doğrudan yapıştırılsaydı "\x4" "1" gibi kaçışlar birbirine karışırdı. */
+    Expr *e = NewExpr(p, EXPR_STRING);
+    ByteBuffer joined = {0};
+    while (p->token.kind == TOKEN_STRING) {
+      if (joined.size > 0)
+        PutBytes(&joined, " ", 1);
+      PutBytes(&joined, p->token.start, p->token.length);
+      NextToken(p);
+    }
+    e->text = AstStrndup(p->ast, (char *)joined.data, joined.size);
+    free(joined.data);
+    return e;
+  }
+  case TOKEN_CHAR: {
+    NextToken(p);
+    Expr *e = NewExpr(p, EXPR_CHAR);
+    e->text = AstStrndup(p->ast, token.start, token.length);
+    return e;
+  }
+  case TOKEN_IDENT: {
+    NextToken(p);
+    Expr *e = NewExpr(p, EXPR_IDENT);
+    e->text = AstStrndup(p->ast, token.start, token.length);
+    return e;
+  }
+  default:
+    break;
+  }
+
+  if (AcceptOp(p, "(")) {
+    Expr *e = ParseExpression(p);
+    ExpectOp(p, ")");
+    return e;
+  }
+
+  ParseError(p, token.kind == TOKEN_END ? "İfade eksik" : "İfade bekleniyordu");
+  return MakeInt(p, 0);
+}
+
+Expr **ParseArguments(Parser *p, const char *close, int *count) {
+  Expr *items[64];
+  *count = 0;
+  if (!IsOp(p, close)) {
+    do {
+      Expr *arg = ParseExpression(p);
+      if (*count < 64)
+        items[(*count)++] = arg;
+      else
+        ParseError(p, "Çok fazla argüman");
+    } while (AcceptOp(p, ",") && !ParseFailed(p));
+  }
+
+  Expr **args = AstAlloc(p->ast, (*count > 0 ? *count : 1) * sizeof(Expr *));
+  memcpy(args, items, *count * sizeof(Expr *));
+  return args;
+}
+
+Expr *ParsePostfix(Parser *p) {
+  Expr *e = ParsePrimary(p);
+  while (!ParseFailed(p)) {
+    if (IsOp(p, "(") && e->kind == EXPR_IDENT) {
+      NextToken(p);
+      Expr *call = NewExpr(p, EXPR_CALL);
+      call->left = e;
+      call->args = ParseArguments(p, ")", &call->argCount);
+      ExpectOp(p, ")");
+      e = call;
+    } else if (IsOp(p, ".") || IsOp(p, "->")) {
+      Expr *member = NewExpr(p, EXPR_MEMBER);
+      member->op = p->token.op;
+      member->left = e;
+      NextToken(p);
+      if (p->token.kind != TOKEN_IDENT) {
+        ParseError(p, TextFormat("'%s' sonrası alan adı bekleniyordu",
+                                 member->op));
+        break;
+      }
+      member->text = AstStrndup(p->ast, p->token.start, p->token.length);
+      NextToken(p);
+      e = member;
+    } else if (AcceptOp(p, "[")) {
+      Expr *index = NewExpr(p, EXPR_INDEX);
+      index->left = e;
+      index->right = ParseExpression(p);
+      ExpectOp(p, "]");
+      e = index;
+    } else if (IsOp(p, "++") || IsOp(p, "--")) {
+      Expr *post = NewExpr(p, EXPR_POSTFIX);
+      post->op = p->token.op;
+      post->left = e;
+      if (!IsLvalue(e))
+        ParseError(p, TextFormat("'%s' bir değişkene uygulanmalı", post->op));
+      NextToken(p);
+      e = post;
+    } else {
+      break;
+    }
+  }
+  return e;
+}
+
+/* "(" bir tür adıyla devam ediyorsa türü okur ve ")" dahil tüketir. */
+const char *ParseTypeInParens(Parser *p) {
+  Parser lookahead = *p;
+  NextToken(&lookahead);
+  if (!IsTypeWord(&lookahead.token))
+    return NULL;
+
+  *p = lookahead;
+  ByteBuffer type = {0};
+  while (IsTypeWord(&p->token) || IsOp(p, "*")) {
+    if (type.size > 0 && p->token.kind == TOKEN_IDENT)
+      PutBytes(&type, " ", 1);
+    PutBytes(&type, p->token.start, p->token.length);
+    NextToken(p);
+  }
+  ExpectOp(p, ")");
+  const char *name = AstStrndup(p->ast, (char *)type.data, type.size);
+  free(type.data);
+  return name;
+}
+
+Expr *ParseUnary(Parser *p) {
+  if (p->token.kind == TOKEN_IDENT && p->token.length == 6 &&
+      strncmp(p->token.start, "sizeof", 6) == 0) {
+    NextToken(p);
+    Expr *e = NewExpr(p, EXPR_SIZEOF);
+    if (!IsOp(p, "(") || !(e->op = ParseTypeInParens(p)))
+      e->left = ParseUnary(p);
+    return e;
+  }
+
+  if (p->token.kind == TOKEN_OP) {
+    const char *op = p->token.op;
+    if (strcmp(op, "(") == 0) {
+      /* "(int) x" gibi tür dönüşümleri. */
+      const char *type = ParseTypeInParens(p);
+      if (type) {
+        Expr *cast = NewExpr(p, EXPR_CAST);
+        cast->op = type;
+        cast->left = ParseUnary(p);
+        /* int'e sığmayan değerde dönüşüm sarar; float sabiti yazılamaz. */
+        double value = IsNumber(cast->left) ? NumberValue(cast->left) : 0;
+        if (IsNumber(cast->left) && strcmp(cast->op, "int") == 0 &&
+            value > INT_MIN && value < INT_MAX + 1.0)
+          return MakeInt(p, (long long)value);
+        if (IsNumber(cast->left) && strcmp(cast->op, "double") == 0 &&
+            (IsIntConstant(cast->left) || IsDoubleConstant(cast->left)))
+          return MakeFloat(p, value);
+        return cast;
+      }
+    } else if (strchr("-+!~&*", op[0]) && op[1] == '\0') {
+      NextToken(p);
+      Expr *e = NewExpr(p, EXPR_UNARY);
+      e->op = op;
+      e->left = ParseUnary(p);
+      return FoldUnary(p, e);
+    } else if (strcmp(op, "++") == 0 || strcmp(op, "--") == 0) {
+      NextToken(p);
+      Expr *e = NewExpr(p, EXPR_UNARY);
+      e->op = op;
+      e->left = ParseUnary(p);
+      if (!IsLvalue(e->left))
+        ParseError(p, TextFormat("'%s' bir değişkene uygulanmalı", op));
+      return e;
+    }
+  }
+  return ParsePostfix(p);
+}
+
+Expr *ParseBinary(Parser *p, int minPrecedence) {
+  Expr *left = ParseUnary(p);
+  while (!ParseFailed(p) && p->token.kind == TOKEN_OP) {
+    int precedence = BinaryPrecedence(p->token.op);
+    if (precedence == 0 || precedence < minPrecedence)
+      break;
+
+    Expr *e = NewExpr(p, EXPR_BINARY);
+    e->op = p->token.op;
+    NextToken(p);
+    e->left = left;
+    e->right = ParseBinary(p, precedence + 1);
+    left = FoldBinary(p, e);
+  }
+  return left;
+}
+
+Expr *ParseTernary(Parser *p) {
+  Expr *cond = ParseBinary(p, PREC_OR);
+  if (!AcceptOp(p, "?"))
+    return cond;
+
+  Expr *e = NewExpr(p, EXPR_TERNARY);
+  e->left = cond;
+  e->right = ParseExpression(p);
+  ExpectOp(p, ":");
+  e->third = ParseTernary(p);
+  if (IsNumber(cond))
+    return NumberValue(cond) != 0 ? e->right : e->third;
+  return e;
+}
+
+Expr *ParseExpression(Parser *p) {
+  Expr *left = ParseTernary(p);
+  if (p->token.kind == TOKEN_OP && IsAssignOp(p->token.op)) {
+    Expr *e = NewExpr(p, EXPR_ASSIGN);
+    e->op = p->token.op;
+    NextToken(p);
+    if (!IsLvalue(left))
+      ParseError(p, "Atamanın sol tarafı değişken olmalı");
+    e->left = left;
+    e->right = ParseExpression(p);
+    return e;
+  }
+  return left;
+}
+
+/* Virgül işleci yalnızca döngü başlığında kabul edilir; argüman listelerinde
+ * virgül ayırıcıdır. */
+Expr *ParseCommaExpression(Parser *p) {
+  Expr *left = ParseExpression(p);
+  while (!ParseFailed(p) && AcceptOp(p, ",")) {
+    Expr *e = NewExpr(p, EXPR_COMMA);
+    e->left = left;
+    e->right = ParseExpression(p);
+    left = e;
+  }
+  return left;
+}
+
+/* "int a, b = 5, *p, ad[20]" */
+void ParseDeclaration(Parser *p, Declaration *decl) {
+  ByteBuffer type = {0};
+  while (IsTypeWord(&p->token)) {
+    if (type.size > 0)
+      PutBytes(&type, " ", 1);
+    PutBytes(&type, p->token.start, p->token.length);
+    NextToken(p);
+  }
+  if (type.size == 0) {
+    ParseError(p, "Tür bekleniyordu (int, float, char, string...)");
+    return;
+  }
+  decl->type = AstStrndup(p->ast, (char *)type.data, type.size);
+  free(type.data);
+
+  Declarator items[64];
+  int count = 0;
+  do {
+    Declarator item = {0};
+    while (AcceptOp(p, "*"))
+      item.pointerDepth++;
+    if (p->token.kind != TOKEN_IDENT || IsTypeWord(&p->token)) {
+      ParseError(p, "Değişken adı bekleniyordu");
+      return;
+    }
+    item.name = AstStrndup(p->ast, p->token.start, p->token.length);
+    NextToken(p);
+    if (AcceptOp(p, "[")) {
+      item.arraySize = ParseExpression(p);
+      ExpectOp(p, "]");
+    }
+    if (AcceptOp(p, "=")) {
+      if (AcceptOp(p, "{")) {
+        item.init = NewExpr(p, EXPR_LIST);
+        item.init->args = ParseArguments(p, "}", &item.init->argCount);
+        ExpectOp(p, "}");
+      } else {
+        item.init = ParseExpression(p);
+      }
+    }
+    if (count < 64)
+      items[count++] = item;
+  } while (AcceptOp(p, ",") && !ParseFailed(p));
+
+  decl->items = AstAlloc(p->ast, count * sizeof(Declarator));
+  memcpy(decl->items, items, count * sizeof(Declarator));
+  decl->count = count;
+}
+
+/* printf biçimindeki dönüşüm sayısı; "%%" sayılmaz. */
+int CountFormatArgs(const char *format) {
+  int count = 0;
+  for (const char *c = format; *c; c++) {
+    if (*c != '%')
+      continue;
+    if (c[1] == '%') {
+      c++;
+      continue;
+    }
+    count++;
+    for (c++; *c && !strchr("diouxXeEfgGcspn", *c); c++) {
+      if (*c == '*')
+        count++;
+    }
+    if (!*c)
+      break;
+  }
+  return count;
+}
+
+void CollectUsedNames(ByteBuffer *out, const Expr *e) {
+  if (!e)
+    return;
+  /* Çağrılan adlar denetlenmez; kütüphane fonksiyonlarını derleyici bulur. */
+  if (e->kind == EXPR_IDENT)
+    PutInt(out, InternSymbol(e->text));
+  else if (e->kind != EXPR_CALL)
+    CollectUsedNames(out, e->left);
+
+  CollectUsedNames(out, e->right);
+  CollectUsedNames(out, e->third);
+  for (int i = 0; i < e->argCount; i++)
+    CollectUsedNames(out, e->args[i]);
+}
+
+int *CopyNames(NodeAst *ast, ByteBuffer *names, int *count) {
+  *count = names->size / sizeof(int);
+  int *copy = AstAlloc(ast, names->size);
+  if (names->size > 0)
+    memcpy(copy, names->data, names->size);
+  free(names->data);
+  return copy;
+}
+
+/* Doğrulama katmanı için düğümün bildirdiği ve kullandığı adlar. */
+void CollectNodeNames(NodeAst *ast) {
+  ByteBuffer declared = {0}, used = {0};
+
+  for (int i = 0; i < ast->decl.count; i++) {
+    const Declarator *item = &ast->decl.items[i];
+    PutInt(&declared, InternSymbol(item->name));
+    CollectUsedNames(&used, item->arraySize);
+    CollectUsedNames(&used, item->init);
+  }
+  CollectUsedNames(&used, ast->expr);
+  CollectUsedNames(&used, ast->init);
+  CollectUsedNames(&used, ast->step);
+  for (int i = 0; i < ast->argCount; i++)
+    CollectUsedNames(&used, ast->args[i]);
+
+  ast->declared = CopyNames(ast, &declared, &ast->declaredCount);
+  ast->used = CopyNames(ast, &used, &ast->usedCount);
+}
+
+/* Düğüm metnini türüne göre ayrıştırır; hata varsa ast->error doludur. */
+NodeAst *ParseNode(int index) {
+  NodeAst *ast = calloc(1, sizeof(NodeAst));
+  if (!ast) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+
+  NodeType type = nodes.type[index];
+  const char *text = nodes.cold[index].text;
+  Parser parser = {.ast = ast, .pos = text};
+  Parser *p = &parser;
+
+  /* Yeni eklenen düğümün varsayılan metni hata sayılmaz; derlemede
+   * "metin girilmemiş" olarak bildirilir. */
+  if (type != NODE_START && strcmp(text, NODE_TYPE_NAME[type]) == 0)
+    return ast;
+  NextToken(p);
+
+  switch (type) {
+  case NODE_START: {
+    FunctionInfo fn;
+    if (!ParseFunctionSignature(text, &fn)) {
+      ParseError(p, "Geçersiz fonksiyon imzası");
+    } else {
+      /* Fonksiyon adı ve parametreler bildirim sayılır. */
+      CodegenContext params = {0};
+      AddParamsToVars(&params, fn.params);
+      ByteBuffer declared = {0};
+      PutInt(&declared, InternSymbol(fn.name));
+      for (int i = 0; i < params.var_count; i++) {
+        PutInt(&declared, InternSymbol(params.vars[i].name));
+        free(params.vars[i].name);
+        free(params.vars[i].type);
+      }
+      ast->declared = CopyNames(ast, &declared, &ast->declaredCount);
+    }
+    FreeFunctionInfo(&fn);
+    return ast;
+  }
+  case NODE_END:
+    if (p->token.kind == TOKEN_END)
+      return ast;
+    ast->expr = ParseExpression(p);
+    break;
+  case NODE_PROCESS: {
+    Expr *items[64];
+    while (p->token.kind != TOKEN_END && !ParseFailed(p)) {
+      Expr *e = ParseExpression(p);
+      if (ast->argCount < 64)
+        items[ast->argCount++] = e;
+      else
+        ParseError(p, "Çok fazla ifade");
+      if (!AcceptOp(p, ";"))
+        break;
+    }
+    ast->args = AstAlloc(ast, (ast->argCount + 1) * sizeof(Expr *));
+    memcpy(ast->args, items, ast->argCount * sizeof(Expr *));
+    break;
+  }
+  case NODE_OUTPUT:
+  case NODE_INPUT:
+    ast->args = ParseArguments(p, ")", &ast->argCount);
+    if (ParseFailed(p))
+      break;
+    if (ast->argCount == 0 || ast->args[0]->kind != EXPR_STRING) {
+      ParseError(p, "İlk argüman tırnak içinde metin olmalı");
+    } else if (type == NODE_INPUT &&
+               (ast->argCount != 2 || ast->args[1]->kind != EXPR_IDENT)) {
+      ParseError(p, "Biçim: \"soru\", değişken");
+    } else if (type == NODE_OUTPUT &&
+               CountFormatArgs(ast->args[0]->text) != ast->argCount - 1) {
+      ParseError(p, TextFormat("Biçim %d değer bekliyor, %d verildi",
+                               CountFormatArgs(ast->args[0]->text),
+                               ast->argCount - 1));
+    }
+    break;
+  case NODE_VARIABLE:
+    ParseDeclaration(p, &ast->decl);
+    break;
+  case NODE_LOOP: {
+    /* Noktalı virgül varsa for, yoksa while döngüsüdür. */
+    bool isFor = false;
+    for (Parser scan = *p; scan.token.kind != TOKEN_END && !isFor;
+         NextToken(&scan))
+      isFor = IsOp(&scan, ";");
+    ast->error[0] = '\0'; // tarama hataları asıl ayrıştırmada yine bulunur
+
+    if (isFor) {
+      ast->isFor = true;
+      if (IsTypeWord(&p->token))
+        ParseDeclaration(p, &ast->decl);
+      else if (!IsOp(p, ";"))
+        ast->init = ParseCommaExpression(p);
+      ExpectOp(p, ";");
+      if (!IsOp(p, ";"))
+        ast->expr = ParseCommaExpression(p);
+      ExpectOp(p, ";");
+      if (p->token.kind != TOKEN_END)
+        ast->step = ParseCommaExpression(p);
+    } else {
+      ast->expr = ParseExpression(p);
+    }
+    break;
+  }
+  default: // Karar, Çağır
+    ast->expr = ParseExpression(p);
+    break;
+  }
+
+  if (!ParseFailed(p) && p->token.kind != TOKEN_END)
+    ParseError(p, TextFormat("Fazladan '%.*s'", p->token.length,
+                             p->token.start));
+  if (!ParseFailed(p))
+    CollectNodeNames(ast);
+  return ast;
+}
+
+/* Metin değişmedikçe ağaç yeniden kurulmaz. */
+NodeAst *GetNodeAst(int index) {
+  NodeCold *cold = &nodes.cold[index];
+  if (!cold->ast) {
+    cold->ast = ParseNode(index);
+    ValidateNodeParsed(index);
+  }
+  return cold->ast;
+}
+
+/* Kanvasta gösterilecek hata; yoksa NULL. */
+const char *GetNodeError(int index) {
+  NodeAst *ast = nodes.cold[index].ast;
+  if (!ast)
+    return NULL;
+  if (ast->error[0])
+    return ast->error;
+  if (ast->compileError[0])
+    return ast->compileError;
+  return NULL;
+}
+
+/* --ifade türleri ve C üretimi-- */
+
+typedef struct {
+  const char *name;
+  ValueType type;
+} BuiltinSymbol;
+
+/* Ön bölümdeki başlıklardan sık kullanılanlar. */
+const BuiltinSymbol BUILTIN_FUNCTIONS[] = {
+    {"printf", VALUE_INT},     {"scanf", VALUE_INT},
+    {"puts", VALUE_INT},       {"putchar", VALUE_INT},
+    {"getchar", VALUE_INT},    {"fputs", VALUE_INT},
+    {"fgets", VALUE_STRING},   {"fflush", VALUE_INT},
+    {"sprintf", VALUE_INT},    {"snprintf", VALUE_INT},
+    {"sscanf", VALUE_INT},     {"strlen", VALUE_INT},
+    {"strcmp", VALUE_INT},     {"strncmp", VALUE_INT},
+    {"strcpy", VALUE_STRING},  {"strncpy", VALUE_STRING},
+    {"strcat", VALUE_STRING},  {"strncat", VALUE_STRING},
+    {"strchr", VALUE_STRING},  {"strrchr", VALUE_STRING},
+    {"strstr", VALUE_STRING},  {"memset", VALUE_UNKNOWN},
+    {"memcpy", VALUE_UNKNOWN}, {"malloc", VALUE_UNKNOWN},
+    {"calloc", VALUE_UNKNOWN}, {"realloc", VALUE_UNKNOWN},
+    {"free", VALUE_VOID},      {"exit", VALUE_VOID},
+    {"abs", VALUE_INT},        {"labs", VALUE_INT},
+    {"atoi", VALUE_INT},       {"atof", VALUE_FLOAT},
+    {"strtol", VALUE_INT},     {"strtod", VALUE_FLOAT},
+    {"rand", VALUE_INT},       {"srand", VALUE_VOID},
+    {"toupper", VALUE_INT},    {"tolower", VALUE_INT},
+    {"sqrt", VALUE_FLOAT},     {"pow", VALUE_FLOAT},
+    {"sin", VALUE_FLOAT},      {"cos", VALUE_FLOAT},
+    {"tan", VALUE_FLOAT},      {"atan", VALUE_FLOAT},
+    {"atan2", VALUE_FLOAT},    {"fabs", VALUE_FLOAT},
+    {"floor", VALUE_FLOAT},    {"ceil", VALUE_FLOAT},
+    {"round", VALUE_FLOAT},    {"fmod", VALUE_FLOAT},
+    {"fmin", VALUE_FLOAT},     {"fmax", VALUE_FLOAT},
+    {"log", VALUE_FLOAT},      {"log10", VALUE_FLOAT},
+    {"exp", VALUE_FLOAT}};
+
+const BuiltinSymbol BUILTIN_CONSTANTS[] = {
+    {"true", VALUE_INT},      {"false", VALUE_INT},
+    {"NULL", VALUE_UNKNOWN},  {"EOF", VALUE_INT},
+    {"RAND_MAX", VALUE_INT},  {"M_PI", VALUE_FLOAT},
+    {"stdin", VALUE_UNKNOWN}, {"stdout", VALUE_UNKNOWN},
+    {"stderr", VALUE_UNKNOWN}};
+
+const BuiltinSymbol *FindBuiltin(const BuiltinSymbol *table, int count,
+                                 const char *name) {
+  for (int i = 0; i < count; i++) {
+    if (strcmp(table[i].name, name) == 0)
+      return &table[i];
+  }
+  return NULL;
+}
+
+/* Değişken tablosundaki tür adı: "char*", "int[]", "string"... */
+char *DeclaratorType(const char *type, const Declarator *item) {
+  char *name = strprintf("%s%.*s%s", type, item->pointerDepth > 8
+                                               ? 8
+                                               : item->pointerDepth,
+                         "********", item->arraySize ? "[]" : "");
+  if (!name) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  return name;
+}
+
+ValueType ValueTypeFromName(const char *type) {
+  if (strcmp(type, "string") == 0 ||
+      (strstr(type, "char") && strpbrk(type, "*[")))
+    return VALUE_STRING;
+  if (strpbrk(type, "*["))
+    return VALUE_UNKNOWN;
+  if (strstr(type, "float") || strstr(type, "double"))
+    return VALUE_FLOAT;
+  if (strstr(type, "char"))
+    return VALUE_CHAR;
+  if (strstr(type, "void"))
+    return VALUE_VOID;
+  return VALUE_INT;
+}
+
+bool IsNumeric(ValueType type) {
+  return type == VALUE_INT || type == VALUE_FLOAT || type == VALUE_CHAR;
+}
+
+/* İş parçacıklarından çağrılır; TextFormat'ın ortak tamponu kullanılmaz. */
+void ReportNodeError(CodegenContext *ctx, int index, const char *format, ...) {
+  char message[160];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+
+  for (int i = 0; i < ctx->errorCount; i++) {
+    if (ctx->errors[i].index == index &&
+        strcmp(ctx->errors[i].message, message) == 0)
+      return;
+  }
+
+  GROW_ARRAY(ctx->errors, ctx->errorCount + 1);
+  ctx->errors[ctx->errorCount++] =
+      (NodeError){.index = index, .message = strdup(message)};
+}
+
+const FunctionInfo *FindFunction(CodegenContext *ctx, const char *name) {
+  for (int i = 0; i < ctx->functionCount; i++) {
+    if (strcmp(ctx->functions[i].name, name) == 0)
+      return &ctx->functions[i];
+  }
+  return NULL;
+}
+
+int CountParams(const char *params) {
+  if (strcmp(params, "void") == 0)
+    return 0;
+  int count = 1;
+  for (const char *c = params; *c; c++)
+    count += *c == ',';
+  return count;
+}
+
+void CheckAssignable(CodegenContext *ctx, int index, ValueType target,
+                     ValueType value) {
+  if (IsNumeric(target) && value == VALUE_STRING)
+    ReportNodeError(ctx, index, "Metin sayıya atanamaz");
+  else if (target == VALUE_STRING && (value == VALUE_FLOAT ||
+                                      value == VALUE_CHAR))
+    ReportNodeError(ctx, index, "Sayı metne atanamaz");
+  else if (value == VALUE_VOID)
+    ReportNodeError(ctx, index, "Fonksiyon değer döndürmüyor");
+}
+
+/* İfadenin türünü değişken tablosuna göre bulur; tanımsız değişkenleri ve
+ * açık tür uyumsuzluklarını düğüm hatası olarak bildirir. */
+ValueType CheckExpr(CodegenContext *ctx, int index, const Expr *e) {
+  switch (e->kind) {
+  case EXPR_INT:
+    return VALUE_INT;
+  case EXPR_FLOAT:
+    return VALUE_FLOAT;
+  case EXPR_CHAR:
+    return VALUE_CHAR;
+  case EXPR_STRING:
+    return VALUE_STRING;
+  case EXPR_IDENT: {
+    Variable *var = isdefined(ctx, (char *)e->text);
+    if (var)
+      return ValueTypeFromName(var->type);
+    const BuiltinSymbol *constant = FindBuiltin(
+        BUILTIN_CONSTANTS,
+        sizeof(BUILTIN_CONSTANTS) / sizeof(BUILTIN_CONSTANTS[0]), e->text);
+    if (constant)
+      return constant->type;
+    ReportNodeError(ctx, index, "'%s' tanımlanmamış", e->text);
+    return VALUE_UNKNOWN;
+  }
+  case EXPR_CALL: {
+    for (int i = 0; i < e->argCount; i++)
+      CheckExpr(ctx, index, e->args[i]);
+
+    const FunctionInfo *fn = FindFunction(ctx, e->left->text);
+    if (fn) {
+      int expected = CountParams(fn->params);
+      if (expected != e->argCount)
+        ReportNodeError(ctx, index, "%s %d argüman bekliyor, %d verildi",
+                        fn->name, expected, e->argCount);
+      return ValueTypeFromName(fn->returnType);
+    }
+    /* Tabloda olmayan kütüphane fonksiyonları (isdigit, time...) derleyiciye
+     * bırakılır; gerçekten yoksa bağlayıcı bildirir. */
+    const BuiltinSymbol *builtin = FindBuiltin(
+        BUILTIN_FUNCTIONS,
+        sizeof(BUILTIN_FUNCTIONS) / sizeof(BUILTIN_FUNCTIONS[0]),
+        e->left->text);
+    return builtin ? builtin->type : VALUE_UNKNOWN;
+  }
+  case EXPR_SIZEOF:
+    if (e->left)
+      CheckExpr(ctx, index, e->left);
+    return VALUE_INT;
+  case EXPR_MEMBER:
+    CheckExpr(ctx, index, e->left);
+    return VALUE_UNKNOWN;
+  case EXPR_COMMA:
+    CheckExpr(ctx, index, e->left);
+    return CheckExpr(ctx, index, e->right);
+  case EXPR_UNARY: {
+    ValueType type = CheckExpr(ctx, index, e->left);
+    if (strcmp(e->op, "!") == 0)
+      return VALUE_INT;
+    if (strcmp(e->op, "&") == 0)
+      return VALUE_UNKNOWN;
+    if (strcmp(e->op, "*") == 0)
+      return type == VALUE_STRING ? VALUE_CHAR : VALUE_UNKNOWN;
+    if (type == VALUE_STRING && e->op[1] == '\0')
+      ReportNodeError(ctx, index, "'%s' metne uygulanamaz", e->op);
+    if (type == VALUE_FLOAT && strcmp(e->op, "~") == 0)
+      ReportNodeError(ctx, index, "'~' ondalık sayıya uygulanamaz");
+    return type;
+  }
+  case EXPR_POSTFIX:
+    return CheckExpr(ctx, index, e->left);
+  case EXPR_CAST:
+    CheckExpr(ctx, index, e->left);
+    return ValueTypeFromName(e->op);
+  case EXPR_LIST:
+    for (int i = 0; i < e->argCount; i++)
+      CheckExpr(ctx, index, e->args[i]);
+    return VALUE_UNKNOWN;
+  case EXPR_INDEX: {
+    ValueType type = CheckExpr(ctx, index, e->left);
+    if (CheckExpr(ctx, index, e->right) == VALUE_FLOAT)
+      ReportNodeError(ctx, index, "Dizi indeksi tamsayı olmalı");
+    return type == VALUE_STRING ? VALUE_CHAR : VALUE_UNKNOWN;
+  }
+  case EXPR_TERNARY: {
+    CheckExpr(ctx, index, e->left);
+    ValueType a = CheckExpr(ctx, index, e->right),
+              b = CheckExpr(ctx, index, e->third);
+    return a == VALUE_FLOAT || b == VALUE_FLOAT ? VALUE_FLOAT : a;
+  }
+  case EXPR_ASSIGN: {
+    ValueType target = CheckExpr(ctx, index, e->left),
+              value = CheckExpr(ctx, index, e->right);
+    if (strcmp(e->op, "=") == 0)
+      CheckAssignable(ctx, index, target, value);
+    else if (value == VALUE_STRING)
+      ReportNodeError(ctx, index, "'%s' metinle kullanılamaz", e->op);
+    return target;
+  }
+  case EXPR_BINARY: {
+    ValueType a = CheckExpr(ctx, index, e->left),
+              b = CheckExpr(ctx, index, e->right);
+    int precedence = BinaryPrecedence(e->op);
+
+    if (precedence == PREC_EQUALITY && a == VALUE_STRING &&
+        b == VALUE_STRING) {
+      ReportNodeError(ctx, index, "Metinler strcmp ile karşılaştırılmalı");
+      return VALUE_INT;
+    }
+    if (precedence == PREC_OR || precedence == PREC_AND ||
+        precedence == PREC_EQUALITY || precedence == PREC_RELATIONAL)
+      return VALUE_INT;
+
+    bool integral = precedence != PREC_ADDITIVE &&
+                    precedence != PREC_MULTIPLICATIVE;
+    integral |= strcmp(e->op, "%") == 0;
+    if ((a == VALUE_STRING || b == VALUE_STRING) &&
+        (integral || precedence == PREC_MULTIPLICATIVE)) {
+      ReportNodeError(ctx, index, "'%s' metne uygulanamaz", e->op);
+      return VALUE_UNKNOWN;
+    }
+    if ((a == VALUE_FLOAT || b == VALUE_FLOAT) && integral) {
+      ReportNodeError(ctx, index, "'%s' ondalık sayıya uygulanamaz", e->op);
+      return VALUE_UNKNOWN;
+    }
+
+    if (a == VALUE_STRING || b == VALUE_STRING)
+      return VALUE_STRING;
+    if (a == VALUE_FLOAT || b == VALUE_FLOAT)
+      return VALUE_FLOAT;
+    if (a == VALUE_UNKNOWN || b == VALUE_UNKNOWN)
+      return VALUE_UNKNOWN;
+    return VALUE_INT;
+  }
+  }
+  return VALUE_UNKNOWN;
+}
+
+/* Bildirilen adları tabloya ekler. "scoped" döngü başlığındaki gibi kendi
+ * kapsamı olan bildirimlerdir; aynı adın yeniden bildirilmesine izin
+ * verilir. */
+void CheckDeclaration(CodegenContext *ctx, int index, const Declaration *decl,
+                      bool scoped) {
+  for (int i = 0; i < decl->count; i++) {
+    const Declarator *item = &decl->items[i];
+    char *type = DeclaratorType(decl->type, item);
+
+    if (item->arraySize && CheckExpr(ctx, index, item->arraySize) != VALUE_INT)
+      ReportNodeError(ctx, index, "Dizi boyutu tamsayı olmalı");
+    if (item->init && !item->arraySize)
+      CheckAssignable(ctx, index, ValueTypeFromName(type),
+                      CheckExpr(ctx, index, item->init));
+    else if (item->init)
+      CheckExpr(ctx, index, item->init);
+
+    if (!isdefined(ctx, (char *)item->name))
+      addToVars(ctx, type, (char *)item->name);
+    else if (!scoped)
+      ReportNodeError(ctx, index, "'%s' zaten tanımlı", item->name);
+    free(type);
+  }
+}
+
+/* printf biçimindeki her dönüşümün argüman türüyle uyuştuğunu denetler. */
+void CheckFormatArgs(CodegenContext *ctx, int index, Expr **args,
+                     int argCount) {
+  const char *format = args[0]->text;
+  int arg = 1;
+  for (const char *c = format; *c && arg <= argCount; c++) {
+    if (*c != '%')
+      continue;
+    if (c[1] == '%') {
+      c++;
+      continue;
+    }
+
+    for (c++; *c && !strchr("diouxXeEfgGcspn", *c); c++) {
+      if (*c == '*' && arg < argCount &&
+          CheckExpr(ctx, index, args[arg++]) == VALUE_FLOAT)
+        ReportNodeError(ctx, index, "'*' genişliği tamsayı olmalı");
+    }
+    if (!*c || arg >= argCount)
+      break;
+
+    ValueType type = CheckExpr(ctx, index, args[arg++]);
+    bool ok = type == VALUE_UNKNOWN ||
+              (strchr("diouxXc", *c) && (type == VALUE_INT ||
+                                         type == VALUE_CHAR)) ||
+              (strchr("eEfgG", *c) && type == VALUE_FLOAT) ||
+              (*c == 's' && type == VALUE_STRING) || strchr("pn", *c);
+    if (!ok)
+      ReportNodeError(ctx, index, "%d. değer %%%c ile yazdırılamaz", arg - 1,
+                      *c);
+  }
+  for (; arg < argCount; arg++)
+    CheckExpr(ctx, index, args[arg]);
+}
+
+void PutText(ByteBuffer *out, const char *text) {
+  PutBytes(out, text, strlen(text));
+}
+
+int ExprPrecedence(const Expr *e) {
+  switch (e->kind) {
+  case EXPR_COMMA:
+    return PREC_COMMA;
+  case EXPR_ASSIGN:
+    return PREC_ASSIGN;
+  case EXPR_TERNARY:
+    return PREC_TERNARY;
+  case EXPR_BINARY:
+    return BinaryPrecedence(e->op);
+  case EXPR_UNARY:
+  case EXPR_CAST:
+  case EXPR_SIZEOF:
+    return PREC_UNARY;
+  case EXPR_INT:
+  case EXPR_FLOAT:
+    /* Negatif sabit "(-1)[a]" gibi yerlerde ayraç ister. */
+    return NumberValue(e) < 0 || (e->text && e->text[0] == '-')
+               ? PREC_UNARY
+               : PREC_PRIMARY;
+  default:
+    return PREC_PRIMARY;
+  }
+}
+
+void PutNumber(ByteBuffer *out, const Expr *e) {
+  char number[32];
+  if (e->text) {
+    PutText(out, e->text);
+  } else if (e->kind == EXPR_INT) {
+    snprintf(number, sizeof(number), "%lld", e->intValue);
+    PutText(out, number);
+  } else {
+    /* Geri okunduğunda aynı değeri veren en kısa yazım. */
+    snprintf(number, sizeof(number), "%.15g", e->floatValue);
+    if (strtod(number, NULL) != e->floatValue)
+      snprintf(number, sizeof(number), "%.17g", e->floatValue);
+    if (!strpbrk(number, ".eEni"))
+      strcat(number, ".0");
+    PutText(out, number);
+  }
+}
+
+/* Ağacı C koduna çevirir; yalnızca öncelik gerektirdiğinde ayraç koyar. */
+void EmitExpr(ByteBuffer *out, const Expr *e, int minPrecedence) {
+  bool paren = ExprPrecedence(e) < minPrecedence;
+  if (paren)
+    PutText(out, "(");
+
+  switch (e->kind) {
+  case EXPR_INT:
+  case EXPR_FLOAT:
+    PutNumber(out, e);
+    break;
+  case EXPR_CHAR:
+  case EXPR_STRING:
+  case EXPR_IDENT:
+    PutText(out, e->text);
+    break;
+  case EXPR_UNARY: {
+    PutText(out, e->op);
+    /* "- -x" ve "+ +x" bitişik yazılırsa "--x" olur. */
+    const Expr *x = e->left;
+    if ((x->kind == EXPR_UNARY && x->op[0] == e->op[0]) ||
+        (ExprPrecedence(x) == PREC_UNARY && IsNumber(x) && e->op[0] == '-'))
+      PutText(out, " ");
+    EmitExpr(out, x, PREC_UNARY);
+    break;
+  }
+  case EXPR_POSTFIX:
+    EmitExpr(out, e->left, PREC_POSTFIX);
+    PutText(out, e->op);
+    break;
+  case EXPR_CAST:
+    PutText(out, "(");
+    PutText(out, e->op);
+    PutText(out, ")");
+    EmitExpr(out, e->left, PREC_UNARY);
+    break;
+  case EXPR_MEMBER:
+    EmitExpr(out, e->left, PREC_POSTFIX);
+    PutText(out, e->op);
+    PutText(out, e->text);
+    break;
+  case EXPR_COMMA:
+    EmitExpr(out, e->left, PREC_COMMA);
+    PutText(out, ", ");
+    EmitExpr(out, e->right, PREC_ASSIGN);
+    break;
+  case EXPR_SIZEOF:
+    PutText(out, "sizeof(");
+    if (e->op)
+      PutText(out, e->op);
+    else
+      EmitExpr(out, e->left, PREC_ASSIGN);
+    PutText(out, ")");
+    break;
+  case EXPR_BINARY: {
+    int precedence = BinaryPrecedence(e->op);
+    EmitExpr(out, e->left, precedence);
+    PutText(out, " ");
+    PutText(out, e->op);
+    PutText(out, " ");
+    EmitExpr(out, e->right, precedence + 1);
+    break;
+  }
+  case EXPR_ASSIGN:
+    EmitExpr(out, e->left, PREC_UNARY);
+    PutText(out, " ");
+    PutText(out, e->op);
+    PutText(out, " ");
+    EmitExpr(out, e->right, PREC_ASSIGN);
+    break;
+  case EXPR_TERNARY:
+    EmitExpr(out, e->left, PREC_OR);
+    PutText(out, " ? ");
+    EmitExpr(out, e->right, PREC_ASSIGN);
+    PutText(out, " : ");
+    EmitExpr(out, e->third, PREC_TERNARY);
+    break;
+  case EXPR_CALL:
+  case EXPR_LIST:
+    PutText(out, e->kind == EXPR_CALL ? e->left->text : "");
+    PutText(out, e->kind == EXPR_CALL ? "(" : "{");
+    for (int i = 0; i < e->argCount; i++) {
+      if (i > 0)
+        PutText(out, ", ");
+      EmitExpr(out, e->args[i], PREC_ASSIGN);
+    }
+    PutText(out, e->kind == EXPR_CALL ? ")" : "}");
+    break;
+  case EXPR_INDEX:
+    EmitExpr(out, e->left, PREC_POSTFIX);
+    PutText(out, "[");
+    EmitExpr(out, e->right, PREC_ASSIGN);
+    PutText(out, "]");
+    break;
+  }
+
+  if (paren)
+    PutText(out, ")");
+}
+
+/* Çağıranın serbest bırakacağı, NUL ile biten bir kopya döndürür. */
+char *ExprToC(const Expr *e) {
+  ByteBuffer out = {0};
+  EmitExpr(&out, e, PREC_COMMA);
+  PutBytes(&out, "", 1);
+  return (char *)out.data;
+}
+
+/* Karar düğümünün atlama koşulu. Olumsuzu "!" eklemek yerine mümkünse
+ * işleci çevirerek yazılır; NaN yüzünden yalnızca ==/!= ve ! çevrilir. */
+char *ConditionToC(const Expr *cond, bool negate) {
+  if (!negate)
+    return ExprToC(cond);
+
+  if (cond->kind == EXPR_UNARY && strcmp(cond->op, "!") == 0)
+    return ExprToC(cond->left);
+
+  Expr flipped = *cond;
+  if (cond->kind == EXPR_BINARY && BinaryPrecedence(cond->op) ==
+                                       PREC_EQUALITY) {
+    flipped.op = strcmp(cond->op, "==") == 0 ? "!=" : "==";
+    return ExprToC(&flipped);
+  }
+
+  Expr negated = {.kind = EXPR_UNARY, .op = "!", .left = (Expr *)cond};
+  return ExprToC(&negated);
+}
+
+char *DeclarationToC(const Declaration *decl) {
+  ByteBuffer out = {0};
+  PutText(&out, decl->type);
+  for (int i = 0; i < decl->count; i++) {
+    const Declarator *item = &decl->items[i];
+    PutText(&out, i > 0 ? ", " : " ");
+    for (int k = 0; k < item->pointerDepth; k++)
+      PutText(&out, "*");
+    PutText(&out, item->name);
+    if (item->arraySize) {
+      PutText(&out, "[");
+      EmitExpr(&out, item->arraySize, PREC_ASSIGN);
+      PutText(&out, "]");
+    }
+    if (item->init) {
+      PutText(&out, " = ");
+      EmitExpr(&out, item->init, PREC_ASSIGN);
+    }
+  }
+  PutBytes(&out, "", 1);
+  return (char *)out.data;
+}
+
+/* --canlı doğrulama-- */
+
+int InternSymbol(const char *name) {
+  if (validation.symbolCount * 2 >= validation.bucketCount) {
+    int bucketCount = validation.bucketCount > 0 ? validation.bucketCount * 2
+                                                 : 256;
+    int *buckets = malloc(bucketCount * sizeof(int));
+    if (!buckets) {
+      printf("Bellek tahsisi başarısız!\n");
+      exit(1);
+    }
+    for (int i = 0; i < bucketCount; i++)
+      buckets[i] = -1;
+    for (int s = 0; s < validation.symbolCount; s++) {
+      int b = HashString(validation.symbols[s].name) % bucketCount;
+      while (buckets[b] != -1)
+        b = (b + 1) % bucketCount;
+      buckets[b] = s;
+    }
+
+    bool seed = validation.bucketCount == 0;
+    free(validation.buckets);
+    validation.buckets = buckets;
+    validation.bucketCount = bucketCount;
+
+    /* Ön bölümdeki adlar her zaman tanımlıdır. */
+    if (seed) {
+      for (int i = 0;
+           i < sizeof(BUILTIN_FUNCTIONS) / sizeof(BUILTIN_FUNCTIONS[0]); i++) {
+        int id = InternSymbol(BUILTIN_FUNCTIONS[i].name);
+        validation.symbols[id].builtin = true;
+      }
+      for (int i = 0;
+           i < sizeof(BUILTIN_CONSTANTS) / sizeof(BUILTIN_CONSTANTS[0]); i++) {
+        int id = InternSymbol(BUILTIN_CONSTANTS[i].name);
+        validation.symbols[id].builtin = true;
+      }
+    }
+  }
+
+  int b = HashString(name) % validation.bucketCount;
+  for (; validation.buckets[b] != -1; b = (b + 1) % validation.bucketCount) {
+    if (strcmp(validation.symbols[validation.buckets[b]].name, name) == 0)
+      return validation.buckets[b];
+  }
+
+  GROW_ARRAY(validation.symbols, validation.symbolCount + 1);
+  validation.symbols[validation.symbolCount] =
+      (Symbol){.name = strdup(name), .builtin = false, .declCount = 0};
+  validation.buckets[b] = validation.symbolCount;
+  return validation.symbolCount++;
+}
+
+void CountDeclarations(int index, int delta) {
+  NodeAst *ast = nodes.cold[index].ast;
+  if (!ast)
+    return;
+  for (int i = 0; i < ast->declaredCount; i++)
+    validation.symbols[ast->declared[i]].declCount += delta;
+}
+
+void ReserveValidationScratch(void) {
+  int capacity = validation.scratchCapacity;
+  if (nodes.count <= capacity)
+    return;
+
+  GROW_ARRAY(validation.queue, nodes.capacity);
+  GROW_ARRAY(validation.internal, nodes.capacity);
+  GROW_ARRAY(validation.work, nodes.capacity);
+  GROW_ARRAY(validation.stamp, nodes.capacity);
+  memset(validation.stamp + capacity, 0,
+         (nodes.capacity - capacity) * sizeof(unsigned));
+  validation.scratchCapacity = nodes.capacity;
+}
+
+/* Kökten başlayarak henüz ulaşılamayan düğümleri işaretler; yalnızca yeni
+ * ulaşılan düğümler ziyaret edilir. */
+void MarkReachable(int root) {
+  if (nodes.flags[root] & NODE_FLAG_REACHABLE)
+    return;
+  ReserveValidationScratch();
+
+  int *queue = validation.queue, count = 0;
+  nodes.flags[root] |= NODE_FLAG_REACHABLE;
+  queue[count++] = root;
+  for (int head = 0; head < count; head++) {
+    int i = queue[head];
+    CountDeclarations(i, 1);
+
+    int links[2] = {nodes.cold[i].next, nodes.cold[i].alt_next};
+    for (int k = 0; k < 2; k++) {
+      int s = links[k];
+      if (s == NODE_NONE)
+        continue;
+      nodes.cold[s].reachIn++;
+      if (!(nodes.flags[s] & NODE_FLAG_REACHABLE)) {
+        nodes.flags[s] |= NODE_FLAG_REACHABLE;
+        queue[count++] = s;
+      }
+    }
+  }
+}
+
+/* Bir bağlantı kaldırıldığında hedefinden ileri ulaşılan bölge yeniden
+ * değerlendirilir. Bölge dışından (ya da bir Başla düğümünden) bağlantı alan
+ * düğümler canlı kalır; canlı düğümlerden ulaşılamayanlar düşürülür. Bölge
+ * kendi içindeki döngüleri sayıp kendini ayakta tutamaz, çünkü iç bağlantılar
+ * gelen bağlantı sayısından çıkarılır. */
+void RepairReachability(int start) {
+  if (!(nodes.flags[start] & NODE_FLAG_REACHABLE) ||
+      nodes.type[start] == NODE_START)
+    return;
+  ReserveValidationScratch();
+
+  if (validation.epoch >= (unsigned)-3) {
+    memset(validation.stamp, 0, validation.scratchCapacity * sizeof(unsigned));
+    validation.epoch = 0;
+  }
+  unsigned region = validation.epoch += 2, alive = region + 1;
+  int *queue = validation.queue, *internal = validation.internal;
+  unsigned *stamp = validation.stamp;
+
+  int count = 0;
+  stamp[start] = region;
+  internal[start] = 0;
+  queue[count++] = start;
+  for (int head = 0; head < count; head++) {
+    int links[2] = {nodes.cold[queue[head]].next,
+                    nodes.cold[queue[head]].alt_next};
+    for (int k = 0; k < 2; k++) {
+      int s = links[k];
+      if (s != NODE_NONE && stamp[s] != region) {
+        stamp[s] = region;
+        internal[s] = 0;
+        queue[count++] = s;
+      }
+    }
+  }
+
+  for (int h = 0; h < count; h++) {
+    NodeCold *cold = &nodes.cold[queue[h]];
+    if (cold->next != NODE_NONE)
+      internal[cold->next]++;
+    if (cold->alt_next != NODE_NONE)
+      internal[cold->alt_next]++;
+  }
+
+  int *work = validation.work, top = 0;
+  for (int h = 0; h < count; h++) {
+    int i = queue[h];
+    if (nodes.type[i] == NODE_START || nodes.cold[i].reachIn > internal[i]) {
+      stamp[i] = alive;
+      work[top++] = i;
+    }
+  }
+
+  while (top > 0) {
+    int i = work[--top];
+    int links[2] = {nodes.cold[i].next, nodes.cold[i].alt_next};
+    for (int k = 0; k < 2; k++) {
+      int s = links[k];
+      if (s != NODE_NONE && stamp[s] == region) {
+        stamp[s] = alive;
+        work[top++] = s;
+      }
+    }
+  }
+
+  for (int h = 0; h < count; h++) {
+    int i = queue[h];
+    if (stamp[i] != region)
+      continue;
+    nodes.flags[i] &= ~NODE_FLAG_REACHABLE;
+    CountDeclarations(i, -1);
+    if (nodes.cold[i].next != NODE_NONE)
+      nodes.cold[nodes.cold[i].next].reachIn--;
+    if (nodes.cold[i].alt_next != NODE_NONE)
+      nodes.cold[nodes.cold[i].alt_next].reachIn--;
+  }
+}
+
+void ValidateNodeAdded(int index) {
+  validation.version++;
+  if (!validation.rebuild && nodes.type[index] == NODE_START)
+    MarkReachable(index);
+}
+
+void ValidateLinkChanged(int index, int before, int after) {
+  if (before != after)
+    validation.version++;
+  if (validation.rebuild || before == after ||
+      !(nodes.flags[index] & NODE_FLAG_REACHABLE))
+    return;
+
+  if (after != NODE_NONE) {
+    nodes.cold[after].reachIn++;
+    MarkReachable(after);
+  }
+  if (before != NODE_NONE) {
+    nodes.cold[before].reachIn--;
+    RepairReachability(before);
+  }
+}
+
+/* Metni değişecek düğümün bildirimleri, yeni ağaç kurulunca yeniden sayılır. */
+void ValidateTextChanging(int index) {
+  if (!validation.rebuild && (nodes.flags[index] & NODE_FLAG_REACHABLE))
+    CountDeclarations(index, -1);
+}
+
+void ValidateNodeParsed(int index) {
+  if (!validation.rebuild && (nodes.flags[index] & NODE_FLAG_REACHABLE))
+    CountDeclarations(index, 1);
+}
+
+/* Her karede çağrılır; yalnızca indeksler kaydıysa tüm çizge dolaşılır. */
+void UpdateValidation(void) {
+  if (!validation.rebuild)
+    return;
+  validation.rebuild = false;
+  validation.version++;
+
+  for (int s = 0; s < validation.symbolCount; s++)
+    validation.symbols[s].declCount = 0;
+  for (int i = 0; i < nodes.count; i++) {
+    nodes.flags[i] &= ~NODE_FLAG_REACHABLE;
+    nodes.cold[i].reachIn = 0;
+    GetNodeAst(i);
+  }
+  for (int i = 0; i < nodes.count; i++) {
+    if (nodes.type[i] == NODE_START)
+      MarkReachable(i);
+  }
+}
+
+/* Düğümün kendi bağlantılarına bakar; iş parçacıklarından da çağrılabilir. */
+const char *GetLinkIssue(int index) {
+  NodeType type = nodes.type[index];
+  NodeCold *cold = &nodes.cold[index];
+  if (type != NODE_END && cold->next == NODE_NONE)
+    return "Bağlantı eksik";
+  if (type == NODE_DECISION && cold->alt_next == NODE_NONE)
+    return "\"Hayır\" kolu eksik";
+  if (type == NODE_LOOP && cold->alt_next == NODE_NONE)
+    return "Döngü çıkışı eksik";
+  return NULL;
+}
+
+/* Kanvasta gösterilecek sorun. Ulaşılamayan düğümlerde yalnızca sözdizimi
+ * hataları gösterilir; bağlantı ve ad denetimi akışa giren düğümler içindir. */
+const char *GetNodeIssue(int index) {
+  const char *error = GetNodeError(index);
+  if (error || !(nodes.flags[index] & NODE_FLAG_REACHABLE))
+    return error;
+
+  const char *linkIssue = GetLinkIssue(index);
+  if (linkIssue)
+    return linkIssue;
+
+  NodeType type = nodes.type[index];
+  NodeCold *cold = &nodes.cold[index];
+  if (type != NODE_START && type != NODE_END &&
+      strcmp(cold->text, NODE_TYPE_NAME[type]) == 0)
+    return "Düğüm metni girilmemiş";
+
+  NodeAst *ast = cold->ast;
+  for (int i = 0; ast && i < ast->usedCount; i++) {
+    Symbol *symbol = &validation.symbols[ast->used[i]];
+    if (!symbol->builtin && symbol->declCount == 0)
+      return TextFormat("'%s' tanımlanmamış", symbol->name);
+  }
+  return NULL;
+}
+
+/* --otomatik yerleşim-- */
+
+/* Bileşen içindeki bir bağlantı. Döngüyü kapatan bağlantılar ters çevrilir;
+ * birden çok katman atlayan bağlantılar her ara katmanda bir sahte düğümden
+ * geçer. */
+typedef struct {
+  int from, to; // katman yönünde yerel indeksler
+  int source;   // bağlantının sahibi düğüm
+  int alt;
+  bool reversed;
+  int firstDummy, dummyCount;
+} LayoutEdge;
+
+typedef struct {
+  float key;
+  int position;
+  int vertex;
+} LayoutOrderItem;
+
+int CompareLayoutOrder(const void *a, const void *b) {
+  const LayoutOrderItem *x = a, *y = b;
+  if (x->key != y->key)
+    return x->key < y->key ? -1 : 1;
+  return x->position - y->position;
+}
+
+/* Katmanı anahtara göre sıralar ve sıra numaralarını günceller. */
+void SortLayer(int *items, int count, LayoutOrderItem *order, int *pos) {
+  qsort(order, count, sizeof(LayoutOrderItem), CompareLayoutOrder);
+  for (int i = 0; i < count; i++) {
+    items[i] = order[i].vertex;
+    pos[items[i]] = i;
+  }
+}
+
+/* from[s] → to[s] çiftlerini from'a göre gruplar: v'nin komşuları
+ * items[start[v]] ile items[start[v + 1]] arasındadır. */
+void BuildAdjacency(int n, const int *from, const int *to, int count,
+                    int *start, int *items) {
+  memset(start, 0, (n + 1) * sizeof(int));
+  for (int s = 0; s < count; s++)
+    start[from[s] + 1]++;
+  for (int v = 0; v < n; v++)
+    start[v + 1] += start[v];
+  for (int s = 0; s < count; s++)
+    items[start[from[s]]++] = to[s];
+  for (int v = n; v > 0; v--)
+    start[v] = start[v - 1];
+  start[0] = 0;
+}
+
+/* Katmanı komşu katmandaki sıralara göre ağırlık merkezi ile yeniden
+ * sıralar; komşusu olmayan düğüm yerinde kalır. */
+void OrderLayer(int *items, int count, const int *start, const int *neighbors,
+                LayoutOrderItem *order, int *pos) {
+  for (int i = 0; i < count; i++) {
+    int v = items[i], degree = start[v + 1] - start[v];
+    float total = 0;
+    for (int k = start[v]; k < start[v + 1]; k++)
+      total += pos[neighbors[k]];
+    order[i] = (LayoutOrderItem){degree > 0 ? total / degree : i, i, v};
+  }
+  SortLayer(items, count, order, pos);
+}
+
+/* Katmandaki düğümleri sırayı ve aralıkları bozmadan istenen x'lere kareler
+ * toplamı en küçük olacak biçimde yerleştirir. Aralıklar çıkarılınca problem
+ * azalmayan dizi regresyonuna döner; sırayı bozan komşu bloklar ortalamada
+ * birleştirilir. */
+void PlaceLayer(const int *items, int count, const float *width,
+                const double *desired, double *shift, double *sum, int *size,
+                float *x) {
+  int blocks = 0;
+  double offset = 0;
+  for (int i = 0; i < count; i++) {
+    if (i > 0)
+      offset += (width[items[i - 1]] + width[items[i]]) / 2 + LAYOUT_NODE_GAP;
+    shift[i] = offset;
+    sum[blocks] = desired[i] - offset;
+    size[blocks++] = 1;
+    while (blocks > 1 && sum[blocks - 2] * size[blocks - 1] >
+                             sum[blocks - 1] * size[blocks - 2]) {
+      sum[blocks - 2] += sum[blocks - 1];
+      size[blocks - 2] += size[blocks - 1];
+      blocks--;
+    }
+  }
+
+  for (int b = 0, i = 0; b < blocks; b++) {
+    double mean = sum[b] / size[b];
+    for (int k = 0; k < size[b]; k++, i++)
+      x[items[i]] = mean + shift[i];
+  }
+}
+
+/* Düğümün istenen x'i komşularının ortalamasıdır; toplam ve derece birikir,
+ * böylece iki komşu listesi art arda verilebilir. */
+double NeighborMean(int v, const int *start, const int *neighbors,
+                    const float *x, double *total, int *degree) {
+  for (int k = start[v]; k < start[v + 1]; k++)
+    *total += x[neighbors[k]];
+  *degree += start[v + 1] - start[v];
+  return *degree > 0 ? *total / *degree : x[v];
+}
+
+/* Bir bileşenin katmanlı yerleşimi: döngülerin kırılması, en uzun yol ile
+ * katmanlama, sahte düğümler, ağırlık merkezi ile kesişim azaltma ve katman
+ * başına yatay yerleştirme. Her bileşen havuzdaki ayrı bir iştir. */
+void LayoutComponentTask(void *arg) {
+  LayoutComponent *comp = arg;
+  LayoutJob *job = comp->job;
+  int m = comp->memberCount;
+  const int *members = comp->members, *local = job->localIndex;
+
+  LayoutEdge *edges = NULL;
+  int *from = NULL, *edgeIds = NULL;
+  GROW_ARRAY(edges, 2 * m);
+  GROW_ARRAY(from, 2 * m);
+  GROW_ARRAY(edgeIds, 2 * m);
+  int edgeCount = 0;
+  for (int v = 0; v < m; v++) {
+    int g = members[v], links[2] = {job->next[g], job->alt[g]};
+    for (int k = 0; k < 2; k++) {
+      if (links[k] == NODE_NONE || links[k] == g)
+        continue;
+      edges[edgeCount] = (LayoutEdge){
+          .from = v, .to = local[links[k]], .source = g, .alt = k};
+      from[edgeCount] = v;
+      edgeIds[edgeCount] = edgeCount;
+      edgeCount++;
+    }
+  }
+
+  int *outStart = NULL, *outEdges = NULL, *stack = NULL, *cursor = NULL;
+  GROW_ARRAY(outStart, m + 1);
+  GROW_ARRAY(outEdges, 2 * m);
+  GROW_ARRAY(stack, m);
+  GROW_ARRAY(cursor, m);
+  BuildAdjacency(m, from, edgeIds, edgeCount, outStart, outEdges);
+
+  /* Başla düğümlerinden başlayan derinlik öncelikli aramada yığındaki bir
+   * düğüme dönen bağlantılar ters çevrilir. */
+  unsigned char *state = calloc(m, 1);
+  int *layer = calloc(m, sizeof(int)), *indegree = calloc(m, sizeof(int));
+  if (!state || !layer || !indegree) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  for (int pass = 0; pass < 2; pass++) {
+    for (int root = 0; root < m; root++) {
+      bool start = job->type[members[root]] == NODE_START;
+      if (state[root] || start != (pass == 0))
+        continue;
+      int top = 0;
+      state[root] = 1;
+      cursor[root] = outStart[root];
+      stack[top++] = root;
+      while (top > 0) {
+        int u = stack[top - 1];
+        if (cursor[u] == outStart[u + 1]) {
+          state[u] = 2;
+          top--;
+          continue;
+        }
+        LayoutEdge *edge = &edges[outEdges[cursor[u]++]];
+        if (state[edge->to] == 1) {
+          edge->reversed = true;
+        } else if (state[edge->to] == 0) {
+          state[edge->to] = 1;
+          cursor[edge->to] = outStart[edge->to];
+          stack[top++] = edge->to;
+        }
+      }
+    }
+  }
+  for (int e = 0; e < edgeCount; e++) {
+    if (edges[e].reversed) {
+      int t = edges[e].from;
+      edges[e].from = edges[e].to;
+      edges[e].to = t;
+    }
+    from[e] = edges[e].from;
+  }
+  BuildAdjacency(m, from, edgeIds, edgeCount, outStart, outEdges);
+
+  /* En uzun yol katmanlaması; topolojik sıra ilk sıralamada da kullanılır. */
+  int *rank = cursor;
+  for (int e = 0; e < edgeCount; e++)
+    indegree[edges[e].to]++;
+  int queued = 0, layerCount = 1;
+  for (int v = 0; v < m; v++) {
+    if (indegree[v] == 0)
+      stack[queued++] = v;
+  }
+  for (int head = 0; head < queued; head++) {
+    int u = stack[head];
+    rank[u] = head;
+    if (layer[u] + 1 > layerCount)
+      layerCount = layer[u] + 1;
+    for (int k = outStart[u]; k < outStart[u + 1]; k++) {
+      int t = edges[outEdges[k]].to;
+      if (layer[u] + 1 > layer[t])
+        layer[t] = layer[u] + 1;
+      if (--indegree[t] == 0)
+        stack[queued++] = t;
+    }
+  }
+
+  /* Sahte düğüm sayısı sınırlanır; sınırı aşan uzun bağlantılar sıralamaya
+   * katılmaz ve düz çizilir. */
+  int n = m, dummyLimit = 4 * m + 64, segmentCount = 0;
+  for (int e = 0; e < edgeCount; e++) {
+    int span = layer[edges[e].to] - layer[edges[e].from];
+    edges[e].firstDummy = n;
+    edges[e].dummyCount = 0;
+    if (span == 1) {
+      segmentCount++;
+    } else if (n - m + span - 1 <= dummyLimit) {
+      edges[e].dummyCount = span - 1;
+      n += span - 1;
+      segmentCount += span;
+    }
+  }
+
+  int *vLayer = NULL, *pos = NULL, *upper = NULL, *lower = NULL;
+  float *width = NULL, *key = NULL, *x = NULL;
+  GROW_ARRAY(vLayer, n);
+  GROW_ARRAY(pos, n);
+  GROW_ARRAY(width, n);
+  GROW_ARRAY(key, n);
+  GROW_ARRAY(x, n);
+  GROW_ARRAY(upper, segmentCount + 1);
+  GROW_ARRAY(lower, segmentCount + 1);
+
+  for (int v = 0; v < m; v++) {
+    vLayer[v] = layer[v];
+    width[v] = job->size[members[v]].x;
+    key[v] = rank[v];
+  }
+  int segment = 0;
+  for (int e = 0; e < edgeCount; e++) {
+    LayoutEdge *edge = &edges[e];
+    int prev = edge->from;
+    if (layer[edge->to] - layer[edge->from] > 1 && edge->dummyCount == 0)
+      continue;
+    for (int j = 0; j < edge->dummyCount; j++) {
+      int d = edge->firstDummy + j;
+      vLayer[d] = layer[edge->from] + 1 + j;
+      width[d] = LAYOUT_DUMMY_WIDTH;
+      key[d] = rank[edge->from] + 0.5f;
+      upper[segment] = prev;
+      lower[segment++] = d;
+      prev = d;
+    }
+    upper[segment] = prev;
+    lower[segment++] = edge->to;
+  }
+
+  int *upStart = NULL, *upItems = NULL, *downStart = NULL, *downItems = NULL;
+  GROW_ARRAY(upStart, n + 1);
+  GROW_ARRAY(downStart, n + 1);
+  GROW_ARRAY(upItems, segmentCount + 1);
+  GROW_ARRAY(downItems, segmentCount + 1);
+  BuildAdjacency(n, lower, upper, segmentCount, upStart, upItems);
+  BuildAdjacency(n, upper, lower, segmentCount, downStart, downItems);
+
+  int *layerStart = NULL, *layerItems = NULL;
+  GROW_ARRAY(layerStart, layerCount + 1);
+  GROW_ARRAY(layerItems, n);
+  memset(layerStart, 0, (layerCount + 1) * sizeof(int));
+  for (int v = 0; v < n; v++)
+    layerStart[vLayer[v] + 1]++;
+  for (int l = 0; l < layerCount; l++)
+    layerStart[l + 1] += layerStart[l];
+  for (int v = 0; v < n; v++)
+    layerItems[layerStart[vLayer[v]]++] = v;
+  for (int l = layerCount; l > 0; l--)
+    layerStart[l] = layerStart[l - 1];
+  layerStart[0] = 0;
+
+  LayoutOrderItem *order = NULL;
+  GROW_ARRAY(order, n);
+  for (int l = 0; l < layerCount; l++) {
+    int *items = layerItems + layerStart[l],
+        count = layerStart[l + 1] - layerStart[l];
+    for (int i = 0; i < count; i++)
+      order[i] = (LayoutOrderItem){key[items[i]], items[i], items[i]};
+    SortLayer(items, count, order, pos);
+  }
+
+  /* Kesişim azaltma: katmanlar sırayla aşağı ve yukarı taranır. */
+  for (int sweep = 0; sweep < LAYOUT_SWEEPS; sweep++) {
+    bool down = sweep % 2 == 0;
+    for (int s = 1; s < layerCount; s++) {
+      int l = down ? s : layerCount - 1 - s;
+      OrderLayer(layerItems + layerStart[l], layerStart[l + 1] - layerStart[l],
+                 down ? upStart : downStart, down ? upItems : downItems, order,
+                 pos);
+    }
+  }
+
+  /* Yatay konumlar: her düğüm komşularının ortasına çekilir, katmandaki
+   * sıra ve aralıklar korunur. */
+  double *desired = NULL, *shift = NULL, *sum = NULL;
+  int *size = NULL;
+  GROW_ARRAY(desired, n);
+  GROW_ARRAY(shift, n);
+  GROW_ARRAY(sum, n);
+  GROW_ARRAY(size, n);
+  for (int l = 0; l < layerCount; l++) {
+    int *items = layerItems + layerStart[l],
+        count = layerStart[l + 1] - layerStart[l];
+    for (int i = 0; i < count; i++)
+      desired[i] = 0;
+    PlaceLayer(items, count, width, desired, shift, sum, size, x);
+  }
+  for (int pass = 0; pass <= 2 * LAYOUT_ALIGN_PASSES; pass++) {
+    bool down = pass % 2 == 0, both = pass == 2 * LAYOUT_ALIGN_PASSES;
+    for (int s = 0; s < layerCount; s++) {
+      int l = down ? s : layerCount - 1 - s;
+      int *items = layerItems + layerStart[l],
+          count = layerStart[l + 1] - layerStart[l];
+      for (int i = 0; i < count; i++) {
+        double total = 0;
+        int degree = 0;
+        if (down || both)
+          desired[i] = NeighborMean(items[i], upStart, upItems, x, &total,
+                                    &degree);
+        if (!down || both)
+          desired[i] = NeighborMean(items[i], downStart, downItems, x, &total,
+                                    &degree);
+      }
+      PlaceLayer(items, count, width, desired, shift, sum, size, x);
+    }
+  }
+
+  /* Dikey konumlar: her katman en yüksek düğümü kadar yer kaplar. */
+  float *layerY = NULL, minX = INFINITY, maxX = -INFINITY, top = 0;
+  GROW_ARRAY(layerY, layerCount);
+  for (int l = 0; l < layerCount; l++) {
+    float height = 0;
+    for (int i = layerStart[l]; i < layerStart[l + 1]; i++) {
+      int v = layerItems[i];
+      if (v < m)
+        height = fmaxf(height, job->size[members[v]].y);
+    }
+    layerY[l] = top + height / 2;
+    top += height + LAYOUT_LAYER_GAP;
+  }
+  for (int v = 0; v < n; v++) {
+    minX = fminf(minX, x[v] - width[v] / 2);
+    maxX = fmaxf(maxX, x[v] + width[v] / 2);
+  }
+
+  GROW_ARRAY(comp->local, m);
+  for (int v = 0; v < m; v++)
+    comp->local[v] = (Vector2){x[v] - minX, layerY[vLayer[v]]};
+  comp->size = (Vector2){maxX - minX, top - LAYOUT_LAYER_GAP};
+
+  /* Sahte düğümlerden geçen bağlantıların yolu; uçlar düğüm merkezleridir. */
+  for (int e = 0; e < edgeCount; e++) {
+    LayoutEdge *edge = &edges[e];
+    if (edge->dummyCount == 0)
+      continue;
+    LinkRoute *route = &job->routes[2 * edge->source + edge->alt];
+    route->count = edge->dummyCount + 2;
+    route->points = NULL;
+    GROW_ARRAY(route->points, route->count);
+    for (int p = 0; p < route->count; p++) {
+      int k = edge->reversed ? route->count - 1 - p : p;
+      int v = k == 0                  ? edge->from
+              : k == route->count - 1 ? edge->to
+                                      : edge->firstDummy + k - 1;
+      route->points[p] = (Vector2){x[v] - minX, layerY[vLayer[v]]};
+    }
+  }
+
+  free(edges);
+  free(from);
+  free(edgeIds);
+  free(outStart);
+  free(outEdges);
+  free(stack);
+  free(cursor);
+  free(state);
+  free(layer);
+  free(indegree);
+  free(vLayer);
+  free(pos);
+  free(width);
+  free(key);
+  free(x);
+  free(upper);
+  free(lower);
+  free(upStart);
+  free(upItems);
+  free(downStart);
+  free(downItems);
+  free(layerStart);
+  free(layerItems);
+  free(order);
+  free(desired);
+  free(shift);
+  free(sum);
+  free(size);
+  free(layerY);
+
+  pthread_mutex_lock(&job->lock);
+  if (--job->remaining == 0)
+    pthread_cond_signal(&job->finished);
+  pthread_mutex_unlock(&job->lock);
+}
+
+int FindComponent(int *parent, int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+/* Arka plan iş parçacığı: çizgeyi bağlı bileşenlere ayırır, bileşenleri
+ * havuzda yerleştirir ve sonuçları birleştirir. */
+void *LayoutThread(void *arg) {
+  LayoutJob *job = arg;
+  int count = job->count;
+
+  int *parent = NULL, *componentOf = NULL, *memberStart = NULL;
+  GROW_ARRAY(parent, count);
+  GROW_ARRAY(componentOf, count);
+  GROW_ARRAY(memberStart, count + 1);
+  for (int i = 0; i < count; i++)
+    parent[i] = i;
+  for (int i = 0; i < count; i++) {
+    int links[2] = {job->next[i], job->alt[i]};
+    for (int k = 0; k < 2; k++) {
+      if (links[k] == NODE_NONE)
+        continue;
+      int a = FindComponent(parent, i), b = FindComponent(parent, links[k]);
+      if (a != b)
+        parent[a < b ? b : a] = a < b ? a : b;
+    }
+  }
+
+  /* Yalnızca seçim istendiyse seçili düğüm içeren bileşenler yerleşir. */
+  int componentCount = 0;
+  for (int i = 0; i < count; i++) {
+    int root = FindComponent(parent, i);
+    componentOf[i] = root == i ? componentCount++ : componentOf[root];
+  }
+  bool *kept = calloc(componentCount, sizeof(bool));
+  if (!kept) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  for (int i = 0; i < count; i++) {
+    if (!job->seeds || job->seeds[i])
+      kept[componentOf[i]] = true;
+  }
+
+  int *renumber = parent;
+  job->componentCount = 0;
+  for (int c = 0; c < componentCount; c++)
+    renumber[c] = kept[c] ? job->componentCount++ : NODE_NONE;
+  GROW_ARRAY(job->components, job->componentCount + 1);
+  memset(memberStart, 0, (job->componentCount + 1) * sizeof(int));
+  for (int i = 0; i < count; i++) {
+    int c = renumber[componentOf[i]];
+    job->placed[i] = c != NODE_NONE;
+    if (c != NODE_NONE)
+      memberStart[c + 1]++;
+  }
+  for (int c = 0; c < job->componentCount; c++)
+    memberStart[c + 1] += memberStart[c];
+  GROW_ARRAY(job->members, memberStart[job->componentCount] + 1);
+
+  for (int c = 0; c < job->componentCount; c++) {
+    job->components[c] = (LayoutComponent){
+        .job = job, .members = job->members + memberStart[c]};
+  }
+  for (int i = 0; i < count; i++) {
+    int c = renumber[componentOf[i]];
+    if (c == NODE_NONE)
+      continue;
+    LayoutComponent *comp = &job->components[c];
+    job->localIndex[i] = comp->memberCount;
+    comp->members[comp->memberCount++] = i;
+    if (job->type[i] == NODE_START)
+      comp->hasStart = true;
+  }
+  free(kept);
+  free(parent);
+  free(componentOf);
+  free(memberStart);
+
+  job->remaining = job->componentCount;
+  for (int c = 0; c < job->componentCount; c++)
+    ThreadPoolSubmit(&layoutPool, LayoutComponentTask, &job->components[c]);
+  pthread_mutex_lock(&job->lock);
+  while (job->remaining > 0)
+    pthread_cond_wait(&job->finished, &job->lock);
+  pthread_mutex_unlock(&job->lock);
+
+  /* Tüm çizge yerleşirken bileşenler satırlara dizilir, Başla içerenler
+   * önce gelir. Seçim yerleşirken her bileşen eski kutusunun üst ortasına
+   * oturtulur. */
+  float area = 0, rowLimit, originX = INFINITY, originY = INFINITY;
+  for (int i = 0; i < count; i++) {
+    originX = fminf(originX, job->position[i].x - job->size[i].x / 2);
+    originY = fminf(originY, job->position[i].y - job->size[i].y / 2);
+  }
+  for (int c = 0; c < job->componentCount; c++)
+    area += job->components[c].size.x * job->components[c].size.y;
+  rowLimit = fmaxf(LAYOUT_ROW_WIDTH, sqrtf(area) * 1.5f);
+
+  Vector2 cursor = {originX, originY};
+  float rowHeight = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int c = 0; c < job->componentCount; c++) {
+      LayoutComponent *comp = &job->components[c];
+      if (comp->hasStart != (pass == 0))
+        continue;
+
+      Vector2 offset;
+      if (job->seeds) {
+        float minX = INFINITY, maxX = -INFINITY, minY = INFINITY;
+        for (int k = 0; k < comp->memberCount; k++) {
+          int i = comp->members[k];
+          minX = fminf(minX, job->position[i].x - job->size[i].x / 2);
+          maxX = fmaxf(maxX, job->position[i].x + job->size[i].x / 2);
+          minY = fminf(minY, job->position[i].y - job->size[i].y / 2);
+        }
+        offset = (Vector2){(minX + maxX - comp->size.x) / 2, minY};
+      } else {
+        if (cursor.x > originX &&
+            cursor.x + comp->size.x > originX + rowLimit) {
+          cursor = (Vector2){originX, cursor.y + rowHeight +
+                                          LAYOUT_COMPONENT_GAP};
+          rowHeight = 0;
+        }
+        offset = cursor;
+        cursor.x += comp->size.x + LAYOUT_COMPONENT_GAP;
+        rowHeight = fmaxf(rowHeight, comp->size.y);
+      }
+
+      for (int k = 0; k < comp->memberCount; k++) {
+        int i = comp->members[k];
+        job->target[i] = Vector2Add(comp->local[k], offset);
+        for (int r = 2 * i; r < 2 * i + 2; r++) {
+          for (int p = 0; p < job->routes[r].count; p++)
+            job->routes[r].points[p] =
+                Vector2Add(job->routes[r].points[p], offset);
+        }
+      }
+    }
+  }
+
+  pthread_mutex_lock(&job->lock);
+  job->done = true;
+  pthread_mutex_unlock(&job->lock);
+  return NULL;
+}
+
+void FreeLayoutJob(LayoutJob *job) {
+  for (int r = 0; r < 2 * job->count; r++)
+    free(job->routes[r].points);
+  for (int c = 0; c < job->componentCount; c++)
+    free(job->components[c].local);
+  free(job->components);
+  free(job->members);
+  free(job->next);
+  free(job->alt);
+  free(job->type);
+  free(job->size);
+  free(job->position);
+  free(job->seeds);
+  free(job->placed);
+  free(job->localIndex);
+  free(job->target);
+  free(job->routes);
+  pthread_mutex_destroy(&job->lock);
+  pthread_cond_destroy(&job->finished);
+  free(job);
+}
+
+/* Çizgenin anlık görüntüsünü alıp yerleşimi arka planda başlatır. Yalnızca
+ * seçim isteniyorsa seçili düğümlerin bağlı olduğu bileşenler yerleşir. */
+void StartLayout(bool selectionOnly) {
+  if (autoLayout.job || nodes.count == 0)
+    return;
+  FinishLayoutAnimation();
+
+  int count = nodes.count;
+  LayoutJob *job = calloc(1, sizeof(LayoutJob));
+  if (!job) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+  job->count = count;
+  job->version = validation.version;
+  GROW_ARRAY(job->next, count);
+  GROW_ARRAY(job->alt, count);
+  GROW_ARRAY(job->type, count);
+  GROW_ARRAY(job->size, count);
+  GROW_ARRAY(job->position, count);
+  GROW_ARRAY(job->placed, count);
+  GROW_ARRAY(job->localIndex, count);
+  GROW_ARRAY(job->target, count);
+  job->routes = calloc(2 * count, sizeof(LinkRoute));
+  if (!job->routes) {
+    printf("Bellek tahsisi başarısız!\n");
+    exit(1);
+  }
+
+  bool anySelected = false;
+  if (selectionOnly)
+    GROW_ARRAY(job->seeds, count);
+  for (int i = 0; i < count; i++) {
+    job->next[i] = nodes.cold[i].next;
+    job->alt[i] = nodes.cold[i].alt_next;
+    job->type[i] = nodes.type[i];
+    job->size[i] = (Vector2){nodes.maxX[i] - nodes.minX[i],
+                             nodes.maxY[i] - nodes.minY[i]};
+    job->position[i] = GetNodePosition(i);
+    if (selectionOnly) {
+      job->seeds[i] = nodes.flags[i] & NODE_FLAG_SELECTED;
+      anySelected |= job->seeds[i];
+    }
+  }
+
+  pthread_mutex_init(&job->lock, NULL);
+  pthread_cond_init(&job->finished, NULL);
+  if (selectionOnly && !anySelected) {
+    FreeLayoutJob(job);
+    return;
+  }
+
+  /* İş parçacığı açılamazsa yerleşim burada, beklenerek yapılır. */
+  job->threaded = pthread_create(&job->thread, NULL, LayoutThread, job) == 0;
+  if (!job->threaded)
+    LayoutThread(job);
+  autoLayout.job = job;
+}
+
+/* Her karede çağrılır. Biten yerleşim, çizge bu arada yapısal olarak
+ * değişmediyse uygulanır: geri alma kaydı yazılır, yollar düğümlere
+ * aktarılır ve düğümler hedeflerine doğru kaydırılmaya başlar. */
+void PollLayout(void) {
+  LayoutJob *job = autoLayout.job;
+  if (!job)
+    return;
+
+  pthread_mutex_lock(&job->lock);
+  bool done = job->done;
+  pthread_mutex_unlock(&job->lock);
+  if (!done)
+    return;
+
+  if (job->threaded)
+    pthread_join(job->thread, NULL);
+  autoLayout.job = NULL;
+
+  if (job->version != validation.version || job->count != nodes.count) {
+    FreeLayoutJob(job);
+    return;
+  }
+
+  FinishLayoutAnimation();
+  ByteBuffer payload = {0};
+  int moved = 0;
+  for (int i = 0; i < job->count; i++) {
+    if (!job->placed[i])
+      continue;
+
+    for (int k = 0; k < 2; k++) {
+      LinkRoute *route = &nodes.cold[i].route[k];
+      free(route->points);
+      *route = job->routes[2 * i + k];
+      job->routes[2 * i + k] = (LinkRoute){0};
+    }
+
+    Vector2 from = GetNodePosition(i), to = job->target[i];
+    if (from.x == to.x && from.y == to.y)
+      continue;
+    PutInt(&payload, i);
+    PutBytes(&payload, &from, sizeof(Vector2));
+    PutBytes(&payload, &to, sizeof(Vector2));
+    moved++;
+
+    if (autoLayout.animCount == autoLayout.animCapacity) {
+      autoLayout.animCapacity =
+          autoLayout.animCapacity > 0 ? autoLayout.animCapacity * 2 : 256;
+      GROW_ARRAY(autoLayout.animIndex, autoLayout.animCapacity);
+      GROW_ARRAY(autoLayout.animTarget, autoLayout.animCapacity);
+    }
+    autoLayout.animIndex[autoLayout.animCount] = i;
+    autoLayout.animTarget[autoLayout.animCount++] = to;
+  }
+
+  if (moved > 0)
+    JournalPush((JournalEntry){
+        .kind = JOURNAL_LAYOUT, .count = moved, .payload = payload});
+  else
+    free(payload.data);
+  FreeLayoutJob(job);
+}
+
+/* Düğümler hedeflerine üstel yumuşatma ile yaklaşır; yalnızca hareket
+ * halindeki düğümler dolaşılır. */
+void AnimateLayout(float dt) {
+  float t = 1 - expf(-LAYOUT_ANIMATION_SPEED * dt);
+  int kept = 0;
+  for (int k = 0; k < autoLayout.animCount; k++) {
+    int i = autoLayout.animIndex[k];
+    Vector2 target = autoLayout.animTarget[k],
+            pos = Vector2Lerp(GetNodePosition(i), target, t);
+    if (Vector2DistanceSqr(pos, target) < 0.25f) {
+      SetNodePosition(i, target);
+      continue;
+    }
+    SetNodePosition(i, pos);
+    autoLayout.animIndex[kept] = i;
+    autoLayout.animTarget[kept++] = target;
+  }
+  autoLayout.animCount = kept;
+}
+
+/* İndeksleri kaydıran ya da konumlara dayanan işlemlerden önce çağrılır. */
+void FinishLayoutAnimation(void) {
+  for (int k = 0; k < autoLayout.animCount; k++)
+    SetNodePosition(autoLayout.animIndex[k], autoLayout.animTarget[k]);
+  autoLayout.animCount = 0;
+}
+
+void StopLayout(void) {
+  LayoutJob *job = autoLayout.job;
+  if (!job)
+    return;
+  if (job->threaded)
+    pthread_join(job->thread, NULL);
+  autoLayout.job = NULL;
+  FreeLayoutJob(job);
+}
+
+/* Yol, uçları hâlâ yerleşimin bıraktığı yerdeyse geçerlidir. */
+bool IsRouteValid(int index, int target, const LinkRoute *route) {
+  if (route->count < 2)
+    return false;
+  return Vector2DistanceSqr(route->points[0], GetNodePosition(index)) < 1 &&
+         Vector2DistanceSqr(route->points[route->count - 1],
+                            GetNodePosition(target)) < 1;
+}
+
+/* --mesafe alanı yazı tipi-- */
+
+/* Glifi tarar ve atlasın boş satır aralığına yerleştirir; yer kalmazsa atlas
+ * yüksekliği ikiye katlanır. Doku, kuyruk basılırken güncellenir. */
+int AddGlyphSDF(SdfFont *font, int codepoint) {
+  SdfGlyph glyph = {.codepoint = codepoint, .advanceX = SDF_BASE_SIZE / 2};
+  GlyphInfo *info =
+      font->fileData ? LoadFontData(font->fileData, font->fileSize,
+                                    SDF_BASE_SIZE, &codepoint, 1, FONT_SDF)
+                     : NULL;
+
+  if (info) {
+    Image image = info->image;
+    glyph.offsetX = info->offsetX;
+    glyph.offsetY = info->offsetY;
+    glyph.advanceX = info->advanceX > 0 ? info->advanceX : image.width;
+
+    if (codepoint != ' ' && image.data && image.width > 0 &&
+        image.height > 0) {
+      if (font->penX + image.width + 1 > font->width) {
+        font->penX = 1;
+        font->penY += font->rowHeight + 1;
+        font->rowHeight = 0;
+      }
+      while (font->penY + image.height + 1 > font->height) {
+        int height = font->height * 2;
+        GROW_ARRAY(font->pixels, font->width * height * 2);
+        memset(font->pixels + font->width * font->height * 2, 0,
+               font->width * (height - font->height) * 2);
+        font->height = height;
+        font->resized = true;
+      }
+
+      const unsigned char *src = image.data;
+      for (int y = 0; y < image.height; y++) {
+        unsigned char *dst =
+            font->pixels + ((font->penY + y) * font->width + font->penX) * 2;
+        for (int x = 0; x < image.width; x++) {
+          dst[2 * x] = 255;
+          dst[2 * x + 1] = src[y * image.width + x];
+        }
+      }
+      glyph.source = (Rectangle){font->penX, font->penY, image.width,
+                                 image.height};
+      if (font->penY < font->dirtyTop)
+        font->dirtyTop = font->penY;
+      if (font->penY + image.height > font->dirtyBottom)
+        font->dirtyBottom = font->penY + image.height;
+      if (image.height > font->rowHeight)
+        font->rowHeight = image.height;
+      font->penX += image.width + 1;
+    }
+    UnloadFontData(info, 1);
+  }
+
+  GROW_ARRAY(font->glyphs, font->glyphCount + 1);
+  font->glyphs[font->glyphCount] = glyph;
+  return font->glyphCount++;
+}
+
+/* Kod noktasının glifini döndürür; ilk kez görülen glif o anda taranır. */
+const SdfGlyph *GetGlyphSDF(SdfFont *font, int codepoint) {
+  if (font->glyphCount * 2 >= font->bucketCount) {
+    int bucketCount = font->bucketCount > 0 ? font->bucketCount * 2 : 256;
+    int *buckets = malloc(bucketCount * sizeof(int));
+    if (!buckets) {
+      printf("Bellek tahsisi başarısız!\n");
+      exit(1);
+    }
+    for (int i = 0; i < bucketCount; i++)
+      buckets[i] = -1;
+    for (int g = 0; g < font->glyphCount; g++) {
+      int b = (unsigned)font->glyphs[g].codepoint % bucketCount;
+      while (buckets[b] != -1)
+        b = (b + 1) % bucketCount;
+      buckets[b] = g;
+    }
+    free(font->buckets);
+    font->buckets = buckets;
+    font->bucketCount = bucketCount;
+  }
+
+  int b = (unsigned)codepoint % font->bucketCount;
+  for (; font->buckets[b] != -1; b = (b + 1) % font->bucketCount) {
+    if (font->glyphs[font->buckets[b]].codepoint == codepoint)
+      return &font->glyphs[font->buckets[b]];
+  }
+  font->buckets[b] = AddGlyphSDF(font, codepoint);
+  return &font->glyphs[font->buckets[b]];
+}
+
+Vector2 MeasureTextSDF(SdfFont *font, const char *text, float fontSize,
+                       float spacing) {
+  float scale = fontSize / SDF_BASE_SIZE, width = 0, lineWidth = 0;
+  int lines = 1, glyphsOnLine = 0;
+  for (int i = 0; text[i] != '\0';) {
+    int size = 0, codepoint = GetCodepointNext(text + i, &size);
+    i += size;
+    if (codepoint == '\n') {
+      width = fmaxf(width, lineWidth);
+      lineWidth = 0;
+      glyphsOnLine = 0;
+      lines++;
+      continue;
+    }
+    if (glyphsOnLine++ > 0)
+      lineWidth += spacing;
+    lineWidth += GetGlyphSDF(font, codepoint)->advanceX * scale;
+  }
+  return (Vector2){fmaxf(width, lineWidth),
+                   lines * fontSize + (lines - 1) * SDF_LINE_GAP};
+}
+
+/* Sonraki yazılar kesme dikdörtgeninin dışında kalan kısımlarıyla atılır;
+ * NULL kesmeyi kaldırır. Döndürülmüş yazılara uygulanmaz. */
+void SetTextClipSDF(SdfFont *font, const Rectangle *clip) {
+  font->clipping = clip != NULL;
+  if (clip)
+    font->clip = *clip;
+}
+
+/* Glif dörtgeni position etrafında döndürülerek kuyruğa eklenir. */
+void QueueGlyphSDF(SdfFont *font, Rectangle dest, Rectangle source,
+                   Vector2 position, float rotation, Color tint) {
+  if (rotation == 0 && font->clipping) {
+    Rectangle clip = font->clip;
+    float left = fmaxf(dest.x, clip.x), top = fmaxf(dest.y, clip.y),
+          right = fminf(dest.x + dest.width, clip.x + clip.width),
+          bottom = fminf(dest.y + dest.height, clip.y + clip.height);
+    if (left >= right || top >= bottom)
+      return;
+    float sx = source.width / dest.width, sy = source.height / dest.height;
+    source = (Rectangle){source.x + (left - dest.x) * sx,
+                         source.y + (top - dest.y) * sy,
+                         (right - left) * sx, (bottom - top) * sy};
+    dest = (Rectangle){left, top, right - left, bottom - top};
+  }
+
+  if (font->quadCount == font->quadCapacity) {
+    font->quadCapacity = font->quadCapacity > 0 ? font->quadCapacity * 2 : 1024;
+    GROW_ARRAY(font->quads, font->quadCapacity);
+  }
+  TextQuad *quad = &font->quads[font->quadCount++];
+  quad->source = source;
+  quad->color = tint;
+
+  Vector2 corners[4] = {{dest.x, dest.y},
+                        {dest.x, dest.y + dest.height},
+                        {dest.x + dest.width, dest.y + dest.height},
+                        {dest.x + dest.width, dest.y}};
+  float c = cosf(rotation * DEG2RAD), s = sinf(rotation * DEG2RAD);
+  for (int k = 0; k < 4; k++) {
+    Vector2 p = Vector2Subtract(corners[k], position);
+    if (rotation != 0)
+      p = (Vector2){p.x * c - p.y * s, p.x * s + p.y * c};
+    quad->corners[k] = Vector2Add(p, position);
+  }
+}
+
+/* DrawTextPro ile aynı anlam: yazı origin'e göre konumlanır ve position
+ * etrafında döndürülür. Yazı çizilmez, kuyruğa alınır. */
+void DrawTextProSDF(SdfFont *font, const char *text, Vector2 position,
+                    Vector2 origin, float rotation, float fontSize,
+                    float spacing, Color tint) {
+  float scale = fontSize / SDF_BASE_SIZE, penX = -origin.x, penY = -origin.y;
+  for (int i = 0; text[i] != '\0';) {
+    int size = 0, codepoint = GetCodepointNext(text + i, &size);
+    i += size;
+    if (codepoint == '\n') {
+      penX = -origin.x;
+      penY += fontSize + SDF_LINE_GAP;
+      continue;
+    }
+
+    const SdfGlyph *glyph = GetGlyphSDF(font, codepoint);
+    if (glyph->source.width > 0) {
+      Rectangle dest = {position.x + penX + glyph->offsetX * scale,
+                        position.y + penY + glyph->offsetY * scale,
+                        glyph->source.width * scale,
+                        glyph->source.height * scale};
+      QueueGlyphSDF(font, dest, glyph->source, position, rotation, tint);
+    }
+    penX += glyph->advanceX * scale + spacing;
+  }
+}
+
+void DrawTextSDF(SdfFont *font, const char *text, Vector2 position,
+                 float fontSize, float spacing, Color tint) {
+  DrawTextProSDF(font, text, position, Vector2Zero(), 0, fontSize, spacing,
+                 tint);
+}
+
+/* Kuyruktaki tüm yazılar tek doku ve tek gölgelendiriciyle, rlgl'in toplu
+ * çiziminde basılır. Yeni glifler eklendiyse önce doku güncellenir. */
+void FlushTextSDF(SdfFont *font) {
+  if (font->quadCount == 0)
+    return;
+
+  Image atlas = {.data = font->pixels,
+                 .width = font->width,
+                 .height = font->height,
+                 .mipmaps = 1,
+                 .format = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA};
+  if (font->resized) {
+    if (font->texture.id > 0)
+      UnloadTexture(font->texture);
+    font->texture = LoadTextureFromImage(atlas);
+    SetTextureFilter(font->texture, TEXTURE_FILTER_BILINEAR);
+    font->resized = false;
+  } else if (font->dirtyTop < font->dirtyBottom) {
+    UpdateTextureRec(font->texture,
+                     (Rectangle){0, font->dirtyTop, font->width,
+                                 font->dirtyBottom - font->dirtyTop},
+                     font->pixels + font->dirtyTop * font->width * 2);
+  }
+  font->dirtyTop = font->height;
+  font->dirtyBottom = 0;
+
+  float w = font->width, h = font->height;
+  BeginShaderMode(font->shader);
+  rlSetTexture(font->texture.id);
+  rlBegin(RL_QUADS);
+  for (int q = 0; q < font->quadCount; q++) {
+    /* Toplu çizim dolarsa rlgl onu basıp yenisini açar; doku ve kip korunur. */
+    rlCheckRenderBatchLimit(4);
+    TextQuad *quad = &font->quads[q];
+    Rectangle src = quad->source;
+    float u[4] = {src.x, src.x, src.x + src.width, src.x + src.width},
+          v[4] = {src.y, src.y + src.height, src.y + src.height, src.y};
+    rlColor4ub(quad->color.r, quad->color.g, quad->color.b, quad->color.a);
+    rlNormal3f(0, 0, 1);
+    for (int k = 0; k < 4; k++) {
+      rlTexCoord2f(u[k] / w, v[k] / h);
+      rlVertex2f(quad->corners[k].x, quad->corners[k].y);
+    }
+  }
+  rlEnd();
+  rlSetTexture(0);
+  EndShaderMode();
+  font->quadCount = 0;
+}
 
-  tcc_delete(s);
-  return code;
+void UnloadFontT(SdfFont *font) {
+  UnloadTexture(font->texture);
+  UnloadShader(font->shader);
+  UnloadFileData(font->fileData);
+  free(font->pixels);
+  free(font->glyphs);
+  free(font->buckets);
+  free(font->quads);
+  free(font);
 }